@@ -0,0 +1,222 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "JSONBridge.h"
+#include <string.h>
+#include <mutex>
+#include <vector>
+
+using namespace sensorsdata;
+
+// 复用的 direct ByteBuffer 初始容量
+static const size_t kInitialCapacity = 4 * 1024;
+// 复用的 direct ByteBuffer 最大容量，超出时使用临时 ByteBuffer，避免长期占用大块内存
+static const size_t kMaxPooledCapacity = 256 * 1024;
+// 复用的 direct ByteBuffer 最大个数，全部被占用时使用临时 ByteBuffer
+static const size_t kMaxPooledBuffers = 4;
+
+/**
+ * 可复用的 direct ByteBuffer，同一时刻只被一个线程使用
+ */
+struct PooledBuffer {
+    // ByteBuffer 指向的本地内存
+    std::vector<char> memory;
+    // 指向 memory 的 direct ByteBuffer 全局引用
+    jobject byteBuffer;
+    bool inUse;
+
+    PooledBuffer() : byteBuffer(NULL), inUse(false) {}
+};
+
+// 保护 sAdapterClass、sAdapterMethod 以及 sPool 中每个 PooledBuffer 的 inUse，
+// 不在调用 Java 方法期间持有，各线程可以同时创建 JSONObject
+static std::mutex sMutex;
+static jclass sAdapterClass = NULL;
+static jmethodID sAdapterMethod = NULL;
+// PooledBuffer 创建后不释放，被占用期间由占用的线程独自访问
+static std::vector<PooledBuffer *> sPool;
+
+/**
+ * 调用 Java 方法后检查并清除异常，避免后续 JNI 调用崩溃
+ * @param env env
+ * @return 是否发生异常
+ */
+static bool clearException(JNIEnv *env) {
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+        return true;
+    }
+    return false;
+}
+
+/**
+ * 占用一个空闲的 PooledBuffer，调用方需持有 sMutex
+ * @return PooledBuffer，全部被占用时返回 NULL
+ */
+static PooledBuffer *acquireBuffer() {
+    for (std::vector<PooledBuffer *>::const_iterator iterator = sPool.begin(); iterator != sPool.end(); ++iterator) {
+        if (!(*iterator)->inUse) {
+            (*iterator)->inUse = true;
+            return *iterator;
+        }
+    }
+    if (sPool.size() >= kMaxPooledBuffers) {
+        return NULL;
+    }
+    PooledBuffer *buffer = new PooledBuffer();
+    buffer->inUse = true;
+    sPool.push_back(buffer);
+    return buffer;
+}
+
+static void releaseBuffer(PooledBuffer *buffer) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    buffer->inUse = false;
+}
+
+/**
+ * 确保 PooledBuffer 的容量不小于 capacity，调用方需占用该 PooledBuffer
+ * @param env env
+ * @param buffer PooledBuffer
+ * @param capacity 需要的容量
+ * @return 是否成功
+ */
+static bool ensureCapacity(JNIEnv *env, PooledBuffer *buffer, size_t capacity) {
+    if (buffer->byteBuffer != NULL && buffer->memory.size() >= capacity) {
+        return true;
+    }
+    size_t newCapacity = buffer->memory.empty() ? kInitialCapacity : buffer->memory.size();
+    while (newCapacity < capacity) {
+        newCapacity *= 2;
+    }
+    if (buffer->byteBuffer != NULL) {
+        env->DeleteGlobalRef(buffer->byteBuffer);
+        buffer->byteBuffer = NULL;
+    }
+    buffer->memory.resize(newCapacity);
+    jobject byteBuffer = env->NewDirectByteBuffer(&buffer->memory[0], static_cast<jlong>(newCapacity));
+    if (byteBuffer == NULL) {
+        clearException(env);
+        return false;
+    }
+    buffer->byteBuffer = env->NewGlobalRef(byteBuffer);
+    env->DeleteLocalRef(byteBuffer);
+    return buffer->byteBuffer != NULL;
+}
+
+/**
+ * 通过 JSONObject(String) 创建 JSONObject 对象
+ * @param env env
+ * @param json 序列化后的 JSON
+ * @return JSONObject 对象
+ */
+static jobject toJSONObjectByString(JNIEnv *env, const string &json) {
+    jclass classJSONObject = env->FindClass("org/json/JSONObject");
+    if (classJSONObject == NULL) {
+        clearException(env);
+        return NULL;
+    }
+    jmethodID constructMethod = env->GetMethodID(classJSONObject,
+                                                 "<init>",
+                                                 "(Ljava/lang/String;)V");
+    jstring jsonString = env->NewStringUTF(json.c_str());
+    jobject objJSON = env->NewObject(classJSONObject, constructMethod, jsonString);
+    if (clearException(env)) {
+        objJSON = NULL;
+    }
+    env->DeleteLocalRef(jsonString);
+    env->DeleteLocalRef(classJSONObject);
+    return objJSON;
+}
+
+void JSONBridge::setAdapter(JNIEnv *env, jclass adapterClass, jmethodID toJSONObjectMethod) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    if (sAdapterClass != NULL) {
+        env->DeleteGlobalRef(sAdapterClass);
+        sAdapterClass = NULL;
+    }
+    sAdapterMethod = NULL;
+    if (adapterClass != NULL && toJSONObjectMethod != NULL) {
+        sAdapterClass = (jclass) env->NewGlobalRef(adapterClass);
+        sAdapterMethod = toJSONObjectMethod;
+    }
+}
+
+bool JSONBridge::hasAdapter() {
+    std::lock_guard<std::mutex> lock(sMutex);
+    return sAdapterMethod != NULL;
+}
+
+void JSONBridge::reserve(JNIEnv *env, size_t capacity) {
+    if (env == NULL) return;
+    PooledBuffer *buffer;
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        buffer = acquireBuffer();
+    }
+    if (buffer == NULL) return;
+    ensureCapacity(env, buffer, capacity < kMaxPooledCapacity ? capacity : kMaxPooledCapacity);
+    releaseBuffer(buffer);
+}
+
+jobject JSONBridge::toJSONObject(JNIEnv *env, const string &json) {
+    if (env == NULL) {
+        return NULL;
+    }
+    jclass adapterClass;
+    jmethodID adapterMethod;
+    PooledBuffer *buffer = NULL;
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        adapterClass = sAdapterClass;
+        adapterMethod = sAdapterMethod;
+        if (adapterMethod != NULL && json.length() <= kMaxPooledCapacity) {
+            buffer = acquireBuffer();
+        }
+    }
+    if (adapterMethod == NULL) {
+        return toJSONObjectByString(env, json);
+    }
+
+    jobject objJSON = NULL;
+    if (buffer != NULL && ensureCapacity(env, buffer, json.length())) {
+        // Java 层在返回前完成解析，之后才释放该 PooledBuffer
+        memcpy(&buffer->memory[0], json.data(), json.length());
+        objJSON = env->CallStaticObjectMethod(adapterClass, adapterMethod, buffer->byteBuffer,
+                                              static_cast<jint>(json.length()));
+    } else {
+        // 超大 JSON 或没有空闲的 PooledBuffer 时直接包装 json 的内存
+        jobject byteBuffer = env->NewDirectByteBuffer(const_cast<char *>(json.data()),
+                                                      static_cast<jlong>(json.length()));
+        if (byteBuffer != NULL) {
+            objJSON = env->CallStaticObjectMethod(adapterClass, adapterMethod, byteBuffer,
+                                                  static_cast<jint>(json.length()));
+            env->DeleteLocalRef(byteBuffer);
+        }
+    }
+    if (buffer != NULL) {
+        releaseBuffer(buffer);
+    }
+    if (clearException(env)) {
+        objJSON = NULL;
+    }
+    if (objJSON == NULL) {
+        // 适配器只解析 ObjectNode 输出的标准 JSON，例如 nan、inf 等 org.json 可以容忍的数值由 JSONObject 解析
+        return toJSONObjectByString(env, json);
+    }
+    return objJSON;
+}
@@ -0,0 +1,71 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COCOS2DX_SENSORS_JSON_BRIDGE_H_
+#define COCOS2DX_SENSORS_JSON_BRIDGE_H_
+
+#include <jni.h>
+#include <string>
+
+using namespace std;
+
+#define SENSORS_ANALYTICS_JSON_BRIDGE_CLASS "com/sensorsdata/analytics/cocos2dx/SAJSONBridge"
+#define SENSORS_ANALYTICS_JSON_BRIDGE_METHOD "toJSONObject"
+#define SENSORS_ANALYTICS_JSON_BRIDGE_SIGNATURE "(Ljava/nio/ByteBuffer;I)Lorg/json/JSONObject;"
+
+namespace sensorsdata {
+    /**
+     * 将序列化后的 JSON 传递给 Java 层并创建 JSONObject。
+     * 设置了 SAJSONBridge 适配器时，JSON 写入可复用的 direct ByteBuffer，由 Java 层直接从字节解析，
+     * 不创建整个 JSON 的 jstring/String；否则回退到 JSONObject(String)。
+     * 可复用的 ByteBuffer 有多个，调用 Java 方法期间不持有锁，多个线程可以同时创建 JSONObject。
+     * 仅依赖 JNIEnv，不依赖 cocos2d-x。
+     */
+    class JSONBridge {
+    public:
+        /**
+         * 设置 Java 层适配器，需由调用方通过应用 ClassLoader 加载，只在初始化时调用一次
+         * @param env env
+         * @param adapterClass SAJSONBridge 类，内部会建立全局引用
+         * @param toJSONObjectMethod SAJSONBridge.toJSONObject 静态方法
+         */
+        static void setAdapter(JNIEnv *env, jclass adapterClass, jmethodID toJSONObjectMethod);
+
+        /**
+         * 是否已设置 Java 层适配器
+         * @return 是否已设置
+         */
+        static bool hasAdapter();
+
+        /**
+         * 创建 JSONObject 对象，适配器解析失败时回退到 new JSONObject(String)
+         * @param env env
+         * @param json 序列化后的 JSON
+         * @return JSONObject 局部引用，失败时返回 NULL
+         */
+        static jobject toJSONObject(JNIEnv *env, const string &json);
+
+        /**
+         * 预先分配可复用的 direct ByteBuffer
+         * @param env env
+         * @param capacity 容量，单位为字节
+         */
+        static void reserve(JNIEnv *env, size_t capacity);
+    };
+}
+
+#endif // COCOS2DX_SENSORS_JSON_BRIDGE_H_
@@ -16,7 +16,13 @@
  */
 
 #include "../include/SensorsAnalytics.h"
+#include "JSONBridge.h"
+#include "../common/PlatformBridge.h"
+#include "../include/IdentityCache.h"
 #include "cocos2d.h"
+#include <atomic>
+#include <map>
+#include <mutex>
 
 #define SENSORS_ANALYTICS_JAVA_CLASS "com/sensorsdata/analytics/android/sdk/SensorsDataAPI"
 
@@ -25,32 +31,122 @@ USING_NS_CC;
 
 extern "C" {
 
-// 是否在事件属性中增加 $lib_plugin_version 属性
-static bool isAddVersion = true;
+// 是否在事件属性中增加 $lib_plugin_version 属性，游戏线程与 WorkScheduler 的独立线程都会读写，通过 exchange 认领
+static std::atomic<bool> isAddVersion(true);
 // SDK 全局实例
-static jobject sSensorsAPI = NULL;
-// Jni 全局实例
-static JniMethodInfo sInfo;
+static std::atomic<jobject> sSensorsAPI(NULL);
+// 保护 sSensorsAPI 的初始化
+static std::mutex sSensorsAPIMutex;
+// 当前线程的 Jni 方法信息，isSDKMethodExist 返回 true 后在同一线程中使用
+static thread_local JniMethodInfo sInfo;
+// SDK 方法 ID 缓存，key 为方法名 + 方法签名，SDK 中不存在的方法缓存为 NULL
+static std::map<string, jmethodID> sMethodCache;
+static std::mutex sMethodCacheMutex;
+
+// warmUp 时预先查找的 SDK 方法
+static const char *const kSDKMethods[][2] = {
+        {"track",                   "(Ljava/lang/String;Lorg/json/JSONObject;)V"},
+        {"setFlushNetworkPolicy",   "(I)V"},
+        {"getSuperProperties",      "()Lorg/json/JSONObject;"},
+        {"identify",                "(Ljava/lang/String;)V"},
+        {"login",                   "(Ljava/lang/String;Lorg/json/JSONObject;)V"},
+        {"logout",                  "()V"},
+        {"getDistinctId",           "()Ljava/lang/String;"},
+        {"getLoginId",              "()Ljava/lang/String;"},
+        {"getAnonymousId",          "()Ljava/lang/String;"},
+        {"profileSet",              "(Lorg/json/JSONObject;)V"},
+        {"flush",                   "()V"},
+        {"trackTimerStart",         "(Ljava/lang/String;)Ljava/lang/String;"},
+        {"trackTimerPause",         "(Ljava/lang/String;)V"},
+        {"trackTimerResume",        "(Ljava/lang/String;)V"},
+        {"trackTimerEnd",           "(Ljava/lang/String;Lorg/json/JSONObject;)V"},
+        {"clearTrackTimer",         "()V"},
+        {"removeTimer",             "(Ljava/lang/String;)V"},
+        {"registerSuperProperties", "(Lorg/json/JSONObject;)V"},
+        {"unregisterSuperProperty", "(Ljava/lang/String;)V"},
+        {"clearSuperProperties",    "()V"},
+        {"profileSetOnce",          "(Lorg/json/JSONObject;)V"},
+        {"trackInstallation",       "(Ljava/lang/String;Lorg/json/JSONObject;Z)V"},
+        {"trackInstallation",       "(Ljava/lang/String;)V"},
+        {"deleteAll",               "()V"},
+        {"itemSet",                 "(Ljava/lang/String;Ljava/lang/String;Lorg/json/JSONObject;)V"},
+        {"itemDelete",              "(Ljava/lang/String;Ljava/lang/String;)V"},
+};
 
 /**
  *  获取 SDK 实例
  * @return 返回 SDK 实例
  */
 static jobject getSDKInstance() {
-    if (sSensorsAPI != NULL) {
-        return sSensorsAPI;
+    jobject sensorsAPI = sSensorsAPI.load(std::memory_order_acquire);
+    if (sensorsAPI != NULL) {
+        return sensorsAPI;
     }
 
-    if (JniHelper::getStaticMethodInfo(sInfo,
+    std::lock_guard<std::mutex> lock(sSensorsAPIMutex);
+    sensorsAPI = sSensorsAPI.load(std::memory_order_relaxed);
+    if (sensorsAPI != NULL) {
+        return sensorsAPI;
+    }
+    JniMethodInfo info;
+    if (JniHelper::getStaticMethodInfo(info,
                                        SENSORS_ANALYTICS_JAVA_CLASS,
                                        "sharedInstance",
                                        "()Lcom/sensorsdata/analytics/android/sdk/SensorsDataAPI;")) {
-        jobject sensorsAPI = sInfo.env->CallStaticObjectMethod(sInfo.classID, sInfo.methodID);
-        //  建立全局引用，在多线程环境下使用
-        sSensorsAPI = (jobject) sInfo.env->NewGlobalRef(sensorsAPI);
-        sInfo.env->DeleteLocalRef(sensorsAPI);
+        jobject localAPI = info.env->CallStaticObjectMethod(info.classID, info.methodID);
+        if (localAPI != NULL) {
+            //  建立全局引用，在多线程环境下使用
+            sensorsAPI = info.env->NewGlobalRef(localAPI);
+            info.env->DeleteLocalRef(localAPI);
+            sSensorsAPI.store(sensorsAPI, std::memory_order_release);
+        }
+        info.env->DeleteLocalRef(info.classID);
+    }
+    return sensorsAPI;
+}
+
+/**
+ * 查找 SDK 方法 ID，结果会被缓存，之后的调用不再经过 ClassLoader 与 GetMethodID
+ * @param methodName 方法名
+ * @param paramCode 方法签名
+ * @return 方法 ID，SDK 中不存在该方法时返回 NULL
+ */
+static jmethodID resolveSDKMethod(const char *methodName, const char *paramCode) {
+    string key = string(methodName) + paramCode;
+    {
+        std::lock_guard<std::mutex> lock(sMethodCacheMutex);
+        std::map<string, jmethodID>::const_iterator iterator = sMethodCache.find(key);
+        if (iterator != sMethodCache.end()) {
+            return iterator->second;
+        }
+    }
+
+    JniMethodInfo info;
+    jmethodID methodID = NULL;
+    if (JniHelper::getMethodInfo(info, SENSORS_ANALYTICS_JAVA_CLASS, methodName, paramCode)) {
+        methodID = info.methodID;
+        info.env->DeleteLocalRef(info.classID);
     }
-    return sSensorsAPI;
+    std::lock_guard<std::mutex> lock(sMethodCacheMutex);
+    sMethodCache[key] = methodID;
+    return methodID;
+}
+
+/**
+ * 加载 Java 层的 SAJSONBridge 适配器，只加载一次，未集成适配器时回退到 JSONObject(String)
+ */
+static void loadJSONBridgeAdapter() {
+    static std::once_flag onceFlag;
+    std::call_once(onceFlag, []() {
+        JniMethodInfo info;
+        if (JniHelper::getStaticMethodInfo(info,
+                                           SENSORS_ANALYTICS_JSON_BRIDGE_CLASS,
+                                           SENSORS_ANALYTICS_JSON_BRIDGE_METHOD,
+                                           SENSORS_ANALYTICS_JSON_BRIDGE_SIGNATURE)) {
+            JSONBridge::setAdapter(info.env, info.classID, info.methodID);
+            info.env->DeleteLocalRef(info.classID);
+        }
+    });
 }
 
 /**
@@ -60,15 +156,15 @@ static jobject getSDKInstance() {
  * @return 返回 JSONObject 对象
  */
 jobject createJavaJsonObject(JNIEnv *env, const sensorsdata::ObjectNode *properties) {
-    jclass classJSONObject = env->FindClass("org/json/JSONObject");
-    jmethodID constructMethod = env->GetMethodID(classJSONObject,
-                                                 "<init>",
-                                                 "(Ljava/lang/String;)V");
-    string js = ObjectNode::toJson(*properties);
-    jobject objJSON = env->NewObject(classJSONObject, constructMethod,
-                                     env->NewStringUTF(js.c_str()));
-    env->DeleteLocalRef(classJSONObject);
-    return objJSON;
+    loadJSONBridgeAdapter();
+    string json;
+    {
+        StatsTimer serializeTimer(kStatsPhaseSerialize);
+        json = ObjectNode::toJson(*properties);
+    }
+    StatsRecorder::recordBytesSerialized(json.length());
+    StatsTimer bridgeTimer(kStatsPhaseBridge);
+    return JSONBridge::toJSONObject(env, json);
 }
 
 /**
@@ -87,6 +183,28 @@ static string jStringToString(JNIEnv *env, jstring jString) {
     return ret;
 }
 
+/**
+ * 获取驻留事件名对应的 jstring 全局引用，首次调用时创建，之后不再调用 NewStringUTF
+ * @param env env
+ * @param eventKey 驻留的事件名
+ * @return jstring 全局引用，调用方不能释放
+ */
+static jstring internedJavaString(JNIEnv *env, const EventKey &eventKey) {
+    jstring cached = (jstring) InternTable::platformString(eventKey.id);
+    if (cached != NULL) {
+        return cached;
+    }
+    jstring localString = env->NewStringUTF(eventKey.name().c_str());
+    jstring globalString = (jstring) env->NewGlobalRef(localString);
+    env->DeleteLocalRef(localString);
+    if (!InternTable::setPlatformString(eventKey.id, globalString)) {
+        // 其它线程已经创建
+        env->DeleteGlobalRef(globalString);
+        globalString = (jstring) InternTable::platformString(eventKey.id);
+    }
+    return globalString;
+}
+
 /**
  * 判断 SDK 是否存在方法
  * @param methodName 方法名
@@ -94,36 +212,190 @@ static string jStringToString(JNIEnv *env, jstring jString) {
  * @return 是否存在方法，SDK 对象存在且存在方法时，返回 true，其它情况返回 false
  */
 static bool isSDKMethodExist(const char *methodName, const char *paramCode) {
-    if (getSDKInstance() != NULL &&
-        JniHelper::getMethodInfo(sInfo,
-                                 SENSORS_ANALYTICS_JAVA_CLASS,
-                                 methodName,
-                                 paramCode)) {
-        return true;
+    if (getSDKInstance() == NULL) {
+        return false;
+    }
+    jmethodID methodID = resolveSDKMethod(methodName, paramCode);
+    if (methodID == NULL) {
+        return false;
+    }
+    sInfo.env = JniHelper::getEnv();
+    sInfo.methodID = methodID;
+    return sInfo.env != NULL;
+}
+
+/**
+ * 调用 SDK 中返回 String 的无参方法
+ * @param methodName 方法名
+ * @return 方法返回值，方法不存在或返回 null 时为空字符串
+ */
+static string callSDKStringMethod(const char *methodName) {
+    string result;
+    if (isSDKMethodExist(methodName, "()Ljava/lang/String;")) {
+        jstring jResult = (jstring) sInfo.env->CallObjectMethod(getSDKInstance(), sInfo.methodID);
+        result = jStringToString(sInfo.env, jResult);
+        sInfo.env->DeleteLocalRef(jResult);
     }
-    return false;
+    return result;
 }
 
 /**
- * 添加 $lib_plugin_version 属性
+ * 从 SDK 读取用户标识
+ * @return 用户标识快照
+ */
+static IdentitySnapshot readIdentity() {
+    IdentitySnapshot snapshot;
+    snapshot.distinctId = callSDKStringMethod("getDistinctId");
+    snapshot.loginId = callSDKStringMethod("getLoginId");
+    snapshot.anonymousId = callSDKStringMethod("getAnonymousId");
+    return snapshot;
+}
+
+/**
+ * 从 SDK 加载用户标识，仅在 SDK 已初始化时加载一次
+ * @return 当前用户标识快照
+ */
+static std::shared_ptr<const IdentitySnapshot> loadIdentity() {
+    if (!IdentityCache::isLoaded() && getSDKInstance() != NULL) {
+        IdentityCache::load(readIdentity());
+    }
+    return IdentityCache::current();
+}
+
+/**
+ * identify/login/logout 后重新从 SDK 读取用户标识，SDK 可能拒绝或规范化传入的 ID
+ */
+static void reloadIdentity() {
+    if (getSDKInstance() != NULL) {
+        IdentityCache::update(readIdentity());
+    }
+}
+
+/**
+ * 设置 $lib_plugin_version 属性
+ * @param properties 事件属性
+ */
+static void setLibPluginVersion(ObjectNode &properties) {
+    std::vector<std::string> libVersion;
+    libVersion.push_back(SENSORS_ANALYTICS_PLUGIN_VERSION_VALUE);
+    properties.setList(SENSORS_ANALYTICS_PLUGIN_VERSION_KEY, libVersion);
+}
+
+/**
+ * 添加 $lib_plugin_version 属性，只有第一个未设置该属性的事件添加
  * @param properties 事件属性
  */
 static void appendLibPluginVersion(ObjectNode &properties) {
-    std::map<string, ObjectNode::ValueNode>::iterator time_property_iter =
+    std::map<PropertyName, ObjectNode::ValueNode>::iterator time_property_iter =
             properties.propertiesMap.find(SENSORS_ANALYTICS_PLUGIN_VERSION_KEY);
-    if (isAddVersion && time_property_iter == properties.propertiesMap.end()) {
-        std::vector<std::string> libVersion;
-        libVersion.push_back(SENSORS_ANALYTICS_PLUGIN_VERSION_VALUE);
-        properties.setList(SENSORS_ANALYTICS_PLUGIN_VERSION_KEY, libVersion);
-        isAddVersion = false;
+    if (time_property_iter == properties.propertiesMap.end() && isAddVersion.exchange(false)) {
+        setLibPluginVersion(properties);
+    }
+}
+}
+
+bool platform::warmUp() {
+    if (getSDKInstance() == NULL) {
+        return false;
+    }
+    for (size_t i = 0; i < sizeof(kSDKMethods) / sizeof(kSDKMethods[0]); ++i) {
+        resolveSDKMethod(kSDKMethods[i][0], kSDKMethods[i][1]);
+    }
+    loadJSONBridgeAdapter();
+    JNIEnv *env = JniHelper::getEnv();
+    if (env != NULL) {
+        JSONBridge::reserve(env, 4 * 1024);
+    }
+    loadIdentity();
+    return true;
+}
+
+// 事件时间属性
+static const char *const kEventTimeKey = "$time";
+// putEventTime 使用的类、方法与属性名，第一次使用时查找并缓存
+static jclass sDateClass = NULL;
+static jmethodID sDateConstructor = NULL;
+static jmethodID sJSONObjectPutMethod = NULL;
+static jstring sEventTimeKey = NULL;
+static std::once_flag sEventTimeMethodsFlag;
+
+/**
+ * 查找并缓存 java.util.Date 的构造方法与 JSONObject.put，失败时 sDateClass 为 NULL
+ * @param env env
+ */
+static void resolveEventTimeMethods(JNIEnv *env) {
+    std::call_once(sEventTimeMethodsFlag, [env]() {
+        jclass classDate = env->FindClass("java/util/Date");
+        jclass classJSONObject = env->FindClass("org/json/JSONObject");
+        jstring key = env->NewStringUTF(kEventTimeKey);
+        if (classDate != NULL && classJSONObject != NULL && key != NULL) {
+            jmethodID dateConstructor = env->GetMethodID(classDate, "<init>", "(J)V");
+            jmethodID putMethod = env->GetMethodID(classJSONObject, "put",
+                                                   "(Ljava/lang/String;Ljava/lang/Object;)Lorg/json/JSONObject;");
+            if (dateConstructor != NULL && putMethod != NULL) {
+                sDateConstructor = dateConstructor;
+                sJSONObjectPutMethod = putMethod;
+                sEventTimeKey = (jstring) env->NewGlobalRef(key);
+                sDateClass = (jclass) env->NewGlobalRef(classDate);
+            }
+        }
+        if (env->ExceptionCheck()) {
+            env->ExceptionClear();
+        }
+        env->DeleteLocalRef(key);
+        env->DeleteLocalRef(classDate);
+        env->DeleteLocalRef(classJSONObject);
+    });
+}
+
+/**
+ * 将事件时间以 java.util.Date 写入 $time 属性，原生 SDK 以该属性作为事件时间。
+ * 调用方需确认属性中没有用户设置的 $time
+ * @param env env
+ * @param jParam JSONObject 对象
+ * @param eventTimeMillis 事件时间，小于等于 0 时不写入
+ */
+static void putEventTime(JNIEnv *env, jobject jParam, int64_t eventTimeMillis) {
+    if (jParam == NULL || eventTimeMillis <= 0) return;
+    resolveEventTimeMethods(env);
+    if (sDateClass == NULL) return;
+    jobject date = env->NewObject(sDateClass, sDateConstructor, static_cast<jlong>(eventTimeMillis));
+    if (date != NULL) {
+        jobject result = env->CallObjectMethod(jParam, sJSONObjectPutMethod, sEventTimeKey, date);
+        env->DeleteLocalRef(result);
+        env->DeleteLocalRef(date);
+    }
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
     }
 }
+
+/**
+ * 调用 track 方法并释放 jParam，调用前需通过 isSDKMethodExist 获取 sInfo
+ * @param eventName 事件名
+ * @param eventKey 驻留的事件名，未驻留时无效
+ * @param jParam JSONObject 对象
+ */
+static void callTrackMethod(const char *eventName, const EventKey &eventKey, jobject jParam) {
+    bool interned = eventKey.isValid();
+    jstring jEventName = interned ? internedJavaString(sInfo.env, eventKey)
+                                  : sInfo.env->NewStringUTF(eventName);
+    {
+        StatsTimer nativeTimer(kStatsPhaseNative);
+        sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jEventName, jParam);
+    }
+    // 释放对象，驻留的事件名为全局引用，不释放
+    sInfo.env->DeleteLocalRef(jParam);
+    if (!interned) {
+        sInfo.env->DeleteLocalRef(jEventName);
+    }
 }
 
-void SensorsAnalytics::track(const char *eventName, const ObjectNode &properties) {
+void platform::track(const char *eventName, const ObjectNode &properties, const EventKey &eventKey,
+                     int64_t eventTimeMillis) {
+    StatsScope statsScope(kStatsApiTrack);
     // 判断是否存在方法
     if (isSDKMethodExist("track", "(Ljava/lang/String;Lorg/json/JSONObject;)V")) {
-        jstring jEventName = sInfo.env->NewStringUTF(eventName);
         ObjectNode recordProperties;
         // 复制 properties 到 recordProperties
         recordProperties.mergeFrom(properties);
@@ -131,11 +403,40 @@ void SensorsAnalytics::track(const char *eventName, const ObjectNode &properties
         appendLibPluginVersion(recordProperties);
         // 创建 JSONObject 对象
         jobject jParam = createJavaJsonObject(sInfo.env, &recordProperties);
+        // 保留用户设置的 $time
+        if (recordProperties.propertiesMap.find(kEventTimeKey) == recordProperties.propertiesMap.end()) {
+            putEventTime(sInfo.env, jParam, eventTimeMillis);
+        }
         // 调用 track 方法
-        sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jEventName, jParam);
-        // 释放对象
-        sInfo.env->DeleteLocalRef(jParam);
-        sInfo.env->DeleteLocalRef(jEventName);
+        callTrackMethod(eventName, eventKey, jParam);
+    }
+}
+
+void platform::track(const SerializedEvent &event, int64_t eventTimeMillis) {
+    StatsScope statsScope(kStatsApiTrack);
+    if (isSDKMethodExist("track", "(Ljava/lang/String;Lorg/json/JSONObject;)V")) {
+        loadJSONBridgeAdapter();
+        jobject jParam;
+        if (!event.hasProperty(SENSORS_ANALYTICS_PLUGIN_VERSION_KEY) && isAddVersion.exchange(false)) {
+            // 仅第一个事件需要添加 $lib_plugin_version 属性，拼接到共享的 JSON 之后，不修改共享的数据
+            ObjectNode versionProperties;
+            setLibPluginVersion(versionProperties);
+            string versionJson = ObjectNode::toJson(versionProperties);
+            string json(event.json(), 0, event.json().length() - 1);
+            if (event.propertyCount() > 0) {
+                json += ',';
+            }
+            json.append(versionJson, 1, string::npos);
+            StatsTimer bridgeTimer(kStatsPhaseBridge);
+            jParam = JSONBridge::toJSONObject(sInfo.env, json);
+        } else {
+            StatsTimer bridgeTimer(kStatsPhaseBridge);
+            jParam = JSONBridge::toJSONObject(sInfo.env, event.json());
+        }
+        if (!event.hasProperty(kEventTimeKey)) {
+            putEventTime(sInfo.env, jParam, eventTimeMillis);
+        }
+        callTrackMethod(event.eventName().c_str(), event.eventKey(), jParam);
     }
 }
 
@@ -170,46 +471,122 @@ string SensorsAnalytics::getSuperProperties() {
     return superProperties;
 }
 
+/**
+ * 发送队列中的事件，在会影响事件内容的设置变化前调用，使事件按 track 时的状态发送
+ */
+static void drainQueuedEvents() {
+    WorkScheduler::runAll();
+    EventLanes::drainAll();
+}
+
+/**
+ * 用户标识变化前发送队列中的事件与已合并的用户属性，避免归属到其它用户
+ */
+static void flushBeforeIdentityChange() {
+    drainQueuedEvents();
+    ProfileCoalescer::flush();
+}
+
 void SensorsAnalytics::identify(const char *anonymousId) {
+    flushBeforeIdentityChange();
     if (isSDKMethodExist("identify", "(Ljava/lang/String;)V")) {
         jstring jAnonymousId = sInfo.env->NewStringUTF(anonymousId);
         sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jAnonymousId);
         sInfo.env->DeleteLocalRef(jAnonymousId);
+        reloadIdentity();
     }
 }
 
 void SensorsAnalytics::login(const char *loginId) {
+    StatsScope statsScope(kStatsApiLogin);
+    flushBeforeIdentityChange();
     if (isSDKMethodExist("login", "(Ljava/lang/String;Lorg/json/JSONObject;)V")) {
         jstring jLoginId = sInfo.env->NewStringUTF(loginId);
         ObjectNode recordProperties;
         appendLibPluginVersion(recordProperties);
         // 创建 JSONObject 对象
         jobject jParam = createJavaJsonObject(sInfo.env, &recordProperties);
-        sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jLoginId, jParam);
+        {
+            StatsTimer nativeTimer(kStatsPhaseNative);
+            sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jLoginId, jParam);
+        }
         sInfo.env->DeleteLocalRef(jLoginId);
+        sInfo.env->DeleteLocalRef(jParam);
+        reloadIdentity();
     }
 }
 
 void SensorsAnalytics::logout() {
+    flushBeforeIdentityChange();
     if (isSDKMethodExist("logout", "()V")) {
         sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID);
+        reloadIdentity();
+    }
+}
+
+string SensorsAnalytics::getDistinctId() {
+    if (IdentityCache::isLoaded()) {
+        return IdentityCache::current()->distinctId;
     }
+    return loadIdentity()->distinctId;
 }
 
-void SensorsAnalytics::profileSet(const ObjectNode &properties) {
+string SensorsAnalytics::getLoginId() {
+    if (IdentityCache::isLoaded()) {
+        return IdentityCache::current()->loginId;
+    }
+    return loadIdentity()->loginId;
+}
+
+string SensorsAnalytics::getAnonymousId() {
+    if (IdentityCache::isLoaded()) {
+        return IdentityCache::current()->anonymousId;
+    }
+    return loadIdentity()->anonymousId;
+}
+
+void platform::profileSet(const ObjectNode &properties) {
+    StatsScope statsScope(kStatsApiProfileSet);
+    if (!PayloadGuard::acceptEvent(properties)) return;
     if (isSDKMethodExist("profileSet", "(Lorg/json/JSONObject;)V")) {
         jobject jParam = createJavaJsonObject(sInfo.env, &properties);
-        sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jParam);
+        {
+            StatsTimer nativeTimer(kStatsPhaseNative);
+            sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jParam);
+        }
         sInfo.env->DeleteLocalRef(jParam);
     }
 }
 
-void SensorsAnalytics::flush() {
+void platform::flush() {
     if (isSDKMethodExist("flush", "()V")) {
         sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID);
     }
 }
 
+// 在 Director 的 Scheduler 中注册的 key 与 target
+static const char *const kFrameTickKey = "sensorsdata_work_scheduler";
+static char sFrameTickTarget;
+
+void platform::attachFrameTick() {
+    cocos2d::Director::getInstance()->getScheduler()->schedule([](float dt) {
+        WorkScheduler::tick(dt);
+    }, &sFrameTickTarget, 0, false, kFrameTickKey);
+}
+
+void platform::detachFrameTick() {
+    cocos2d::Director::getInstance()->getScheduler()->unschedule(kFrameTickKey, &sFrameTickTarget);
+}
+
+void SensorsAnalytics::flush() {
+    // 先发送 WorkScheduler 中尚未发送的批次，保证事件顺序
+    WorkScheduler::runAll();
+    EventLanes::drainAll();
+    EventFanout::flush();
+    ProfileCoalescer::flush();
+    platform::flush();
+}
+
 string SensorsAnalytics::trackTimerStart(const char *eventName) {
     string eventNameRegex;
     if (isSDKMethodExist("trackTimerStart", "(Ljava/lang/String;)Ljava/lang/String;")) {
@@ -217,6 +594,7 @@ string SensorsAnalytics::trackTimerStart(const char *eventName) {
         jstring jEventNameRegex = (jstring) sInfo.env->CallObjectMethod(getSDKInstance(),
                                                                         sInfo.methodID, jEventName);
         eventNameRegex = jStringToString(sInfo.env, jEventNameRegex);
+        sInfo.env->DeleteLocalRef(jEventNameRegex);
         sInfo.env->DeleteLocalRef(jEventName);
     }
     return eventNameRegex;
@@ -226,6 +604,7 @@ void SensorsAnalytics::trackTimerPause(const char *eventName) {
     if (isSDKMethodExist("trackTimerPause", "(Ljava/lang/String;)V")) {
         jstring jEventName = sInfo.env->NewStringUTF(eventName);
         sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jEventName);
+        sInfo.env->DeleteLocalRef(jEventName);
     }
 }
 
@@ -238,6 +617,8 @@ void SensorsAnalytics::trackTimerResume(const char *eventName) {
 }
 
 void SensorsAnalytics::trackTimerEnd(const char *eventName, const ObjectNode &properties) {
+    StatsScope statsScope(kStatsApiTrackTimerEnd);
+    if (!PayloadGuard::acceptEvent(properties)) return;
     if (isSDKMethodExist("trackTimerEnd", "(Ljava/lang/String;Lorg/json/JSONObject;)V")) {
         jstring jEventName = sInfo.env->NewStringUTF(eventName);
         ObjectNode recordProperties;
@@ -246,7 +627,10 @@ void SensorsAnalytics::trackTimerEnd(const char *eventName, const ObjectNode &pr
         // 添加 $lib_plugin_version 属性
         appendLibPluginVersion(recordProperties);
         jobject jParam = createJavaJsonObject(sInfo.env, &recordProperties);
-        sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jEventName, jParam);
+        {
+            StatsTimer nativeTimer(kStatsPhaseNative);
+            sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jEventName, jParam);
+        }
         sInfo.env->DeleteLocalRef(jEventName);
         sInfo.env->DeleteLocalRef(jParam);
     }
@@ -267,14 +651,21 @@ void SensorsAnalytics::removeTimer(const char *eventName) {
 }
 
 void SensorsAnalytics::registerSuperProperties(const ObjectNode &properties) {
+    StatsScope statsScope(kStatsApiRegisterSuperProperties);
+    if (!PayloadGuard::acceptEvent(properties)) return;
+    drainQueuedEvents();
     if (isSDKMethodExist("registerSuperProperties", "(Lorg/json/JSONObject;)V")) {
         jobject jParam = createJavaJsonObject(sInfo.env, &properties);
-        sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jParam);
+        {
+            StatsTimer nativeTimer(kStatsPhaseNative);
+            sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jParam);
+        }
         sInfo.env->DeleteLocalRef(jParam);
     }
 }
 
 void SensorsAnalytics::unregisterSuperProperty(const char *superPropertyName) {
+    drainQueuedEvents();
     if (isSDKMethodExist("unregisterSuperProperty", "(Ljava/lang/String;)V")) {
         jstring jSuperPropertyName = sInfo.env->NewStringUTF(superPropertyName);
         sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jSuperPropertyName);
@@ -283,27 +674,40 @@ void SensorsAnalytics::unregisterSuperProperty(const char *superPropertyName) {
 }
 
 void SensorsAnalytics::clearSuperProperties() {
+    drainQueuedEvents();
     if (isSDKMethodExist("clearSuperProperties", "()V")) {
         sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID);
     }
 }
 
-void SensorsAnalytics::profileSetOnce(const ObjectNode &properties) {
+void platform::profileSetOnce(const ObjectNode &properties) {
+    StatsScope statsScope(kStatsApiProfileSetOnce);
+    if (!PayloadGuard::acceptEvent(properties)) return;
     if (isSDKMethodExist("profileSetOnce", "(Lorg/json/JSONObject;)V")) {
         jobject jParam = createJavaJsonObject(sInfo.env, &properties);
-        sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jParam);
+        {
+            StatsTimer nativeTimer(kStatsPhaseNative);
+            sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jParam);
+        }
         sInfo.env->DeleteLocalRef(jParam);
     }
 }
 
 void SensorsAnalytics::trackAppInstall(const ObjectNode &properties, bool disableCallback) {
+    StatsScope statsScope(kStatsApiTrackAppInstall);
+    if (!PayloadGuard::acceptEvent(properties)) return;
     if (isSDKMethodExist("trackInstallation", "(Ljava/lang/String;Lorg/json/JSONObject;Z)V")) {
         jobject jParam = createJavaJsonObject(sInfo.env, &properties);
         jstring jEventName = sInfo.env->NewStringUTF("$AppInstall");
-        sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jEventName, jParam,
-                                  disableCallback);
+        {
+            StatsTimer nativeTimer(kStatsPhaseNative);
+            sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jEventName, jParam,
+                                      disableCallback);
+        }
         sInfo.env->DeleteLocalRef(jEventName);
         sInfo.env->DeleteLocalRef(jParam);
+        // 激活事件与关键事件一样立即上传
+        platform::flush();
     }
 }
 
@@ -312,23 +716,33 @@ void SensorsAnalytics::trackAppInstall() {
         jstring jEventName = sInfo.env->NewStringUTF("$AppInstall");
         sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jEventName);
         sInfo.env->DeleteLocalRef(jEventName);
+        platform::flush();
     }
 }
 
 void SensorsAnalytics::deleteAll() {
+    // 丢弃 C++ 层尚未发送的数据，避免在 deleteAll 之后继续上报
+    EventLanes::clear();
+    ProfileCoalescer::clear();
+    EventFanout::clear();
     if (isSDKMethodExist("deleteAll", "()V")) {
         sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID);
     }
 }
 
 void
-SensorsAnalytics::itemSet(const char *itemType, const char *itemId, const ObjectNode &properties) {
+platform::itemSet(const char *itemType, const char *itemId, const ObjectNode &properties) {
+    StatsScope statsScope(kStatsApiItemSet);
+    if (!PayloadGuard::acceptEvent(properties)) return;
     if (isSDKMethodExist("itemSet",
                          "(Ljava/lang/String;Ljava/lang/String;Lorg/json/JSONObject;)V")) {
         jstring jItemType = sInfo.env->NewStringUTF(itemType);
         jstring jItemId = sInfo.env->NewStringUTF(itemId);
         jobject jParam = createJavaJsonObject(sInfo.env, &properties);
-        sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jItemType, jItemId, jParam);
+        {
+            StatsTimer nativeTimer(kStatsPhaseNative);
+            sInfo.env->CallVoidMethod(getSDKInstance(), sInfo.methodID, jItemType, jItemId, jParam);
+        }
         sInfo.env->DeleteLocalRef(jItemType);
         sInfo.env->DeleteLocalRef(jItemId);
         sInfo.env->DeleteLocalRef(jParam);
@@ -336,6 +750,8 @@ SensorsAnalytics::itemSet(const char *itemType, const char *itemId, const Object
 }
 
 void SensorsAnalytics::itemDelete(const char *itemType, const char *itemId) {
+    // 删除后不再发送该 item 尚未发送的属性
+    ProfileCoalescer::discardItem(itemType, itemId);
     if (isSDKMethodExist("itemDelete", "(Ljava/lang/String;Ljava/lang/String;)V")) {
         jstring jItemType = sInfo.env->NewStringUTF(itemType);
         jstring jItemId = sInfo.env->NewStringUTF(itemId);
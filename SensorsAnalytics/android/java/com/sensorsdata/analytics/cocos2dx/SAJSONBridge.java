@@ -0,0 +1,320 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package com.sensorsdata.analytics.cocos2dx;
+
+import org.json.JSONArray;
+import org.json.JSONException;
+import org.json.JSONObject;
+
+import java.nio.ByteBuffer;
+import java.nio.charset.Charset;
+
+/**
+ * 供 C++ 层调用，直接从 direct ByteBuffer 中解析 UTF-8 编码的 JSON 并创建 JSONObject，
+ * 不会先把整个 JSON 解码为 String 再交给 JSONObject 解析
+ */
+public final class SAJSONBridge {
+    private static final Charset UTF_8 = Charset.forName("UTF-8");
+
+    private SAJSONBridge() {
+    }
+
+    /**
+     * 创建 JSONObject 对象
+     *
+     * @param buffer C++ 层复用的 direct ByteBuffer
+     * @param length JSON 的字节数
+     * @return JSONObject 对象，解析失败时返回 null，由 C++ 层回退到 new JSONObject(String)
+     */
+    public static JSONObject toJSONObject(ByteBuffer buffer, int length) {
+        if (buffer == null || length <= 0) {
+            return new JSONObject();
+        }
+        try {
+            Parser parser = new Parser(buffer, length);
+            JSONObject object = parser.readObject();
+            parser.expectEnd();
+            return object;
+        } catch (JSONException e) {
+            return null;
+        } catch (RuntimeException e) {
+            return null;
+        }
+    }
+
+    /**
+     * 按字节解析 JSON，只为属性名与字符串值创建 String
+     */
+    private static final class Parser {
+        private final ByteBuffer buffer;
+        private final int length;
+        private int position;
+        // 解析字符串时复用的字节数组
+        private byte[] scratch = new byte[64];
+        private int scratchLength;
+
+        Parser(ByteBuffer buffer, int length) {
+            this.buffer = buffer;
+            this.length = Math.min(length, buffer.capacity());
+        }
+
+        JSONObject readObject() throws JSONException {
+            expect('{');
+            JSONObject object = new JSONObject();
+            if (peek() == '}') {
+                position++;
+                return object;
+            }
+            while (true) {
+                if (peek() != '"') {
+                    throw new JSONException("Expected property name at " + position);
+                }
+                String key = readString();
+                expect(':');
+                object.put(key, readValue());
+                byte c = next();
+                if (c == '}') {
+                    return object;
+                }
+                if (c != ',') {
+                    throw new JSONException("Expected ',' or '}' at " + position);
+                }
+            }
+        }
+
+        void expectEnd() throws JSONException {
+            skipWhitespace();
+            if (position != length) {
+                throw new JSONException("Unexpected data at " + position);
+            }
+        }
+
+        private JSONArray readArray() throws JSONException {
+            expect('[');
+            JSONArray array = new JSONArray();
+            if (peek() == ']') {
+                position++;
+                return array;
+            }
+            while (true) {
+                array.put(readValue());
+                byte c = next();
+                if (c == ']') {
+                    return array;
+                }
+                if (c != ',') {
+                    throw new JSONException("Expected ',' or ']' at " + position);
+                }
+            }
+        }
+
+        private Object readValue() throws JSONException {
+            switch (peek()) {
+                case '{':
+                    return readObject();
+                case '[':
+                    return readArray();
+                case '"':
+                    return readString();
+                case 't':
+                    readLiteral("true");
+                    return Boolean.TRUE;
+                case 'f':
+                    readLiteral("false");
+                    return Boolean.FALSE;
+                case 'n':
+                    readLiteral("null");
+                    return JSONObject.NULL;
+                default:
+                    return readNumber();
+            }
+        }
+
+        private String readString() throws JSONException {
+            expect('"');
+            scratchLength = 0;
+            while (true) {
+                byte c = readByte();
+                if (c == '"') {
+                    return new String(scratch, 0, scratchLength, UTF_8);
+                }
+                if (c != '\\') {
+                    append(c);
+                    continue;
+                }
+                byte escaped = readByte();
+                switch (escaped) {
+                    case 'b':
+                        append((byte) '\b');
+                        break;
+                    case 'f':
+                        append((byte) '\f');
+                        break;
+                    case 'n':
+                        append((byte) '\n');
+                        break;
+                    case 'r':
+                        append((byte) '\r');
+                        break;
+                    case 't':
+                        append((byte) '\t');
+                        break;
+                    case 'u':
+                        appendCodePoint(readUnicodeEscape());
+                        break;
+                    default:
+                        // '"'、'\\'、'/'
+                        append(escaped);
+                        break;
+                }
+            }
+        }
+
+        private int readUnicodeEscape() throws JSONException {
+            int high = readHex4();
+            if (Character.isHighSurrogate((char) high) && position + 1 < length
+                    && buffer.get(position) == '\\' && buffer.get(position + 1) == 'u') {
+                position += 2;
+                int low = readHex4();
+                if (Character.isLowSurrogate((char) low)) {
+                    return Character.toCodePoint((char) high, (char) low);
+                }
+                throw new JSONException("Invalid surrogate pair at " + position);
+            }
+            return high;
+        }
+
+        private int readHex4() throws JSONException {
+            int value = 0;
+            for (int i = 0; i < 4; i++) {
+                int digit = Character.digit(readByte(), 16);
+                if (digit < 0) {
+                    throw new JSONException("Invalid unicode escape at " + position);
+                }
+                value = (value << 4) | digit;
+            }
+            return value;
+        }
+
+        private Object readNumber() throws JSONException {
+            int start = position;
+            boolean decimal = false;
+            while (position < length) {
+                byte c = buffer.get(position);
+                if (c == '.' || c == 'e' || c == 'E') {
+                    decimal = true;
+                } else if (!(c == '-' || c == '+' || (c >= '0' && c <= '9'))) {
+                    break;
+                }
+                position++;
+            }
+            if (position == start) {
+                throw new JSONException("Unexpected character at " + position);
+            }
+            scratchLength = 0;
+            for (int i = start; i < position; i++) {
+                append(buffer.get(i));
+            }
+            String text = new String(scratch, 0, scratchLength, UTF_8);
+            try {
+                if (decimal) {
+                    return Double.valueOf(text);
+                }
+                long value = Long.parseLong(text);
+                if (value >= Integer.MIN_VALUE && value <= Integer.MAX_VALUE) {
+                    return (int) value;
+                }
+                return value;
+            } catch (NumberFormatException e) {
+                throw new JSONException("Invalid number " + text);
+            }
+        }
+
+        private void readLiteral(String literal) throws JSONException {
+            for (int i = 0; i < literal.length(); i++) {
+                if (readByte() != literal.charAt(i)) {
+                    throw new JSONException("Expected " + literal + " at " + position);
+                }
+            }
+        }
+
+        private void appendCodePoint(int codePoint) {
+            if (codePoint < 0x80) {
+                append((byte) codePoint);
+            } else if (codePoint < 0x800) {
+                append((byte) (0xC0 | (codePoint >> 6)));
+                append((byte) (0x80 | (codePoint & 0x3F)));
+            } else if (codePoint < 0x10000) {
+                append((byte) (0xE0 | (codePoint >> 12)));
+                append((byte) (0x80 | ((codePoint >> 6) & 0x3F)));
+                append((byte) (0x80 | (codePoint & 0x3F)));
+            } else {
+                append((byte) (0xF0 | (codePoint >> 18)));
+                append((byte) (0x80 | ((codePoint >> 12) & 0x3F)));
+                append((byte) (0x80 | ((codePoint >> 6) & 0x3F)));
+                append((byte) (0x80 | (codePoint & 0x3F)));
+            }
+        }
+
+        private void append(byte c) {
+            if (scratchLength == scratch.length) {
+                byte[] grown = new byte[scratch.length * 2];
+                System.arraycopy(scratch, 0, grown, 0, scratchLength);
+                scratch = grown;
+            }
+            scratch[scratchLength++] = c;
+        }
+
+        private void skipWhitespace() {
+            while (position < length) {
+                byte c = buffer.get(position);
+                if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+                    break;
+                }
+                position++;
+            }
+        }
+
+        private byte peek() throws JSONException {
+            skipWhitespace();
+            if (position >= length) {
+                throw new JSONException("Unexpected end of JSON");
+            }
+            return buffer.get(position);
+        }
+
+        private byte next() throws JSONException {
+            byte c = peek();
+            position++;
+            return c;
+        }
+
+        private byte readByte() throws JSONException {
+            if (position >= length) {
+                throw new JSONException("Unexpected end of JSON");
+            }
+            return buffer.get(position++);
+        }
+
+        private void expect(char expected) throws JSONException {
+            if (next() != expected) {
+                throw new JSONException("Expected '" + expected + "' at " + (position - 1));
+            }
+        }
+    }
+}
@@ -0,0 +1,144 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../include/DedupIndex.h"
+#include <math.h>
+#include <string.h>
+
+using namespace sensorsdata;
+
+// 每一代最多使用的哈希函数个数
+static const size_t kMaxHashCount = 16;
+static const double kLn2 = 0.69314718055994530942;
+
+static uint64_t mix64(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+DedupIndex::DedupIndex(const DedupIndexConfig &config) : indexConfig(config), bitCount(64), hashCount(1) {
+    if (indexConfig.capacity == 0) {
+        indexConfig.capacity = 1;
+    }
+    if (!(indexConfig.falsePositiveRate > 0 && indexConfig.falsePositiveRate < 1)) {
+        indexConfig.falsePositiveRate = DedupIndexConfig().falsePositiveRate;
+    }
+    // m = -n * ln(p) / ln(2)^2，k = m / n * ln(2)
+    double n = static_cast<double>(indexConfig.capacity);
+    double bits = -n * log(indexConfig.falsePositiveRate) / (kLn2 * kLn2);
+    bitCount = (static_cast<size_t>(ceil(bits)) + 63) / 64 * 64;
+    if (bitCount < 64) {
+        bitCount = 64;
+    }
+    double hashes = static_cast<double>(bitCount) / n * kLn2;
+    hashCount = static_cast<size_t>(hashes + 0.5);
+    if (hashCount < 1) {
+        hashCount = 1;
+    } else if (hashCount > kMaxHashCount) {
+        hashCount = kMaxHashCount;
+    }
+    current.bits.assign(bitCount / 64, 0);
+    previous.bits.assign(bitCount / 64, 0);
+}
+
+bool DedupIndex::testBits(const Generation &generation, uint64_t hash1, uint64_t hash2, size_t bitCount,
+                          size_t hashCount) {
+    if (generation.count == 0) return false;
+    for (size_t i = 0; i < hashCount; ++i) {
+        uint64_t bit = (hash1 + i * hash2) % bitCount;
+        if ((generation.bits[bit / 64] & (1ULL << (bit % 64))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DedupIndex::add(uint64_t eventId) {
+    uint64_t hash1 = mix64(eventId);
+    // 双重哈希，hash2 不为 0
+    uint64_t hash2 = mix64(hash1) | 1;
+    if (testBits(current, hash1, hash2, bitCount, hashCount)) {
+        return;
+    }
+    if (current.count >= indexConfig.capacity) {
+        // 当前代已写满，丢弃上一代，保持内存固定
+        previous.bits.swap(current.bits);
+        previous.count = current.count;
+        current.bits.assign(bitCount / 64, 0);
+        current.count = 0;
+    }
+    for (size_t i = 0; i < hashCount; ++i) {
+        uint64_t bit = (hash1 + i * hash2) % bitCount;
+        current.bits[bit / 64] |= 1ULL << (bit % 64);
+    }
+    ++current.count;
+}
+
+bool DedupIndex::mightContain(uint64_t eventId) const {
+    uint64_t hash1 = mix64(eventId);
+    uint64_t hash2 = mix64(hash1) | 1;
+    return testBits(current, hash1, hash2, bitCount, hashCount) ||
+           testBits(previous, hash1, hash2, bitCount, hashCount);
+}
+
+void DedupIndex::clear() {
+    current.bits.assign(bitCount / 64, 0);
+    current.count = 0;
+    previous.bits.assign(bitCount / 64, 0);
+    previous.count = 0;
+}
+
+void DedupIndex::save(std::string *output) const {
+    if (!output) return;
+    // 头部依次为位数、哈希函数个数、当前代与上一代的 ID 数，之后为两代的位数组
+    uint64_t header[4] = {bitCount, hashCount, current.count, previous.count};
+    output->assign(reinterpret_cast<const char *>(header), sizeof(header));
+    output->append(reinterpret_cast<const char *>(&current.bits[0]), current.bits.size() * sizeof(uint64_t));
+    output->append(reinterpret_cast<const char *>(&previous.bits[0]), previous.bits.size() * sizeof(uint64_t));
+}
+
+bool DedupIndex::restore(const std::string &data) {
+    uint64_t header[4];
+    size_t wordsBytes = bitCount / 64 * sizeof(uint64_t);
+    if (data.length() != sizeof(header) + 2 * wordsBytes) {
+        return false;
+    }
+    memcpy(header, data.data(), sizeof(header));
+    if (header[0] != bitCount || header[1] != hashCount) {
+        return false;
+    }
+    current.count = static_cast<size_t>(header[2]);
+    previous.count = static_cast<size_t>(header[3]);
+    memcpy(&current.bits[0], data.data() + sizeof(header), wordsBytes);
+    memcpy(&previous.bits[0], data.data() + sizeof(header) + wordsBytes, wordsBytes);
+    return true;
+}
+
+size_t DedupIndex::memoryBytes() const {
+    return (current.bits.size() + previous.bits.size()) * sizeof(uint64_t);
+}
+
+double DedupIndex::expectedFalsePositiveRate() const {
+    // 单代误判率 (1 - e^(-k * n / m))^k，两代任一误判即误判
+    double m = static_cast<double>(bitCount);
+    double k = static_cast<double>(hashCount);
+    double currentRate = pow(1 - exp(-k * static_cast<double>(current.count) / m), k);
+    double previousRate = pow(1 - exp(-k * static_cast<double>(previous.count) / m), k);
+    return 1 - (1 - currentRate) * (1 - previousRate);
+}
@@ -0,0 +1,341 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../include/EventFanout.h"
+#include "../include/SdkStats.h"
+#include "../include/WorkScheduler.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <mutex>
+
+using namespace sensorsdata;
+
+namespace {
+    struct QueuedView {
+        // 入队序号，用于在发送成功后移除已发送的事件
+        uint64_t sequence;
+        EventView view;
+    };
+
+    struct Destination {
+        DestinationConfig config;
+        // 由该目的地的所有 EventView 共享
+        std::shared_ptr<const std::set<string> > strippedProperties;
+        std::deque<QueuedView> events;
+        uint64_t nextSequence;
+        // 是否有一批事件在等待 completion，同一目的地同一时刻只发送一批
+        bool sending;
+        // flush 之后不足一批的事件也发送，队列清空后复位
+        bool flushRequested;
+        // 当前的重试等待时间，发送成功后复位为 0
+        uint32_t retryDelayMillis;
+        // 重试退避结束的时间
+        int64_t retryAtMillis;
+        // 已确认的事件 ID
+        DedupIndex acked;
+        uint64_t ackedEvents;
+        uint64_t failedBatches;
+        uint64_t skippedReplays;
+
+        explicit Destination(const DedupIndexConfig &dedup)
+                : nextSequence(0), sending(false), flushRequested(false), retryDelayMillis(0), retryAtMillis(0),
+                  acked(dedup), ackedEvents(0), failedBatches(0), skippedReplays(0) {}
+
+        size_t batchSize() const {
+            return config.batchSize > 0 ? config.batchSize : 1;
+        }
+    };
+
+    typedef std::shared_ptr<Destination> DestinationPtr;
+
+    // 保护 sDestinations 以及每个 Destination 的状态
+    std::mutex sMutex;
+    std::map<string, DestinationPtr> sDestinations;
+    std::atomic<size_t> sDestinationCount(0);
+
+    int64_t nowMillis() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * 记录一批事件的发送结果，调用方需持有 sMutex
+     * @param destination 目的地
+     * @param batch 发送的事件
+     * @param lastSequence 这批事件中最后一个事件的序号
+     * @param acked 是否已确认
+     */
+    void completeBatch(Destination &destination, const std::vector<EventView> &batch, uint64_t lastSequence,
+                       bool acked) {
+        destination.sending = false;
+        if (!acked) {
+            ++destination.failedBatches;
+            uint32_t maxDelay = destination.config.retryMaxMillis;
+            uint32_t delay = destination.retryDelayMillis == 0 ? destination.config.retryInitialMillis
+                                                               : destination.retryDelayMillis * 2;
+            if (delay > maxDelay || delay < destination.retryDelayMillis) {
+                delay = maxDelay;
+            }
+            destination.retryDelayMillis = delay;
+            destination.retryAtMillis = nowMillis() + delay;
+            return;
+        }
+        destination.retryDelayMillis = 0;
+        destination.retryAtMillis = 0;
+        for (std::vector<EventView>::const_iterator iterator = batch.begin(); iterator != batch.end(); ++iterator) {
+            destination.acked.add(iterator->eventId());
+        }
+        // 发送期间可能因容量限制丢弃了部分事件，按序号移除已发送的事件
+        while (!destination.events.empty() && destination.events.front().sequence <= lastSequence) {
+            destination.events.pop_front();
+            ++destination.ackedEvents;
+        }
+        if (destination.events.empty()) {
+            destination.flushRequested = false;
+        }
+    }
+
+    /**
+     * 取出下一批事件并调用 sender，调用方不能持有 sMutex
+     * @param destination 目的地
+     * @return 是否已调用 sender 且 completion 已被同步调用，此时可以继续发送下一批
+     */
+    bool sendBatch(const DestinationPtr &destination) {
+        std::shared_ptr<std::vector<EventView> > batch(new std::vector<EventView>());
+        uint64_t lastSequence = 0;
+        DestinationSender sender;
+        string name;
+        {
+            std::lock_guard<std::mutex> lock(sMutex);
+            bool ready = !destination->sending && !destination->events.empty() &&
+                         (destination->flushRequested || destination->events.size() >= destination->batchSize()) &&
+                         (destination->retryAtMillis == 0 || nowMillis() >= destination->retryAtMillis);
+            if (!ready) {
+                return false;
+            }
+            size_t count = destination->events.size() < destination->batchSize() ? destination->events.size()
+                                                                                 : destination->batchSize();
+            batch->reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                batch->push_back(destination->events[i].view);
+            }
+            lastSequence = destination->events[count - 1].sequence;
+            sender = destination->config.sender;
+            name = destination->config.name;
+            destination->sending = true;
+        }
+
+        std::shared_ptr<std::atomic<bool> > completed(new std::atomic<bool>(false));
+        sender(name, *batch, [destination, batch, lastSequence, completed](bool acked) {
+            // 忽略重复的回调
+            if (completed->exchange(true)) return;
+            std::lock_guard<std::mutex> lock(sMutex);
+            completeBatch(*destination, *batch, lastSequence, acked);
+        });
+
+        std::lock_guard<std::mutex> lock(sMutex);
+        return completed->load() && !destination->sending;
+    }
+
+    /**
+     * 将事件加入允许该事件的目的地的队列，调用方需持有 sMutex
+     * @param event 序列化后的事件
+     * @param skipAcked 是否跳过可能已确认的事件，只用于 replay，track 的事件不查询去重索引，避免误判导致丢失
+     * @param ready 输出积累满一批的目的地
+     */
+    void enqueueLocked(const std::shared_ptr<const SerializedEvent> &event, bool skipAcked,
+                       std::vector<DestinationPtr> *ready) {
+        for (std::map<string, DestinationPtr>::const_iterator iterator = sDestinations.begin(); iterator != sDestinations.end(); ++iterator) {
+            Destination &destination = *iterator->second;
+            const std::set<string> &allowlist = destination.config.eventAllowlist;
+            if (!allowlist.empty() && allowlist.find(event->eventName()) == allowlist.end()) {
+                continue;
+            }
+            if (skipAcked && destination.acked.mightContain(event->eventId())) {
+                ++destination.skippedReplays;
+                continue;
+            }
+            if (destination.config.capacity != 0 && destination.events.size() >= destination.config.capacity) {
+                destination.events.pop_front();
+                StatsRecorder::recordDroppedEvent();
+            }
+            QueuedView queued;
+            queued.sequence = destination.nextSequence++;
+            queued.view = EventView(event, destination.strippedProperties);
+            destination.events.push_back(queued);
+            if (destination.events.size() >= destination.batchSize()) {
+                ready->push_back(iterator->second);
+            }
+        }
+    }
+
+    /**
+     * 将事件加入队列，WorkScheduler 未启动时在调用方线程中发送已满的批次
+     * @param event 序列化后的事件
+     * @param skipAcked 是否跳过可能已确认的事件
+     */
+    void enqueue(const std::shared_ptr<const SerializedEvent> &event, bool skipAcked) {
+        if (!event || !EventFanout::hasDestinations()) return;
+        std::vector<DestinationPtr> ready;
+        {
+            std::lock_guard<std::mutex> lock(sMutex);
+            enqueueLocked(event, skipAcked, &ready);
+        }
+        // WorkScheduler 启动时由 tick 中的 pump 发送，未启动时同步发送，避免队列写满后丢弃事件
+        if (ready.empty() || WorkScheduler::isRunning()) return;
+        for (std::vector<DestinationPtr>::const_iterator iterator = ready.begin(); iterator != ready.end(); ++iterator) {
+            while (sendBatch(*iterator)) {
+            }
+        }
+    }
+
+    /**
+     * 发送所有目的地中已就绪的批次
+     */
+    void sendReady() {
+        std::vector<DestinationPtr> destinations;
+        {
+            std::lock_guard<std::mutex> lock(sMutex);
+            for (std::map<string, DestinationPtr>::const_iterator iterator = sDestinations.begin(); iterator != sDestinations.end(); ++iterator) {
+                destinations.push_back(iterator->second);
+            }
+        }
+        for (std::vector<DestinationPtr>::const_iterator iterator = destinations.begin(); iterator != destinations.end(); ++iterator) {
+            // sender 同步完成时继续发送，异步完成时留到之后的 pump
+            while (sendBatch(*iterator)) {
+            }
+        }
+    }
+}
+
+bool EventFanout::addDestination(const DestinationConfig &config) {
+    if (config.name.empty() || !config.sender) return false;
+    std::lock_guard<std::mutex> lock(sMutex);
+    DestinationPtr &destination = sDestinations[config.name];
+    if (!destination) {
+        destination.reset(new Destination(config.dedup));
+    } else if (destination->acked.config().capacity != config.dedup.capacity ||
+               destination->acked.config().falsePositiveRate != config.dedup.falsePositiveRate) {
+        destination->acked = DedupIndex(config.dedup);
+    }
+    destination->config = config;
+    destination->strippedProperties.reset(new std::set<string>(config.strippedProperties));
+    sDestinationCount.store(sDestinations.size(), std::memory_order_release);
+    return true;
+}
+
+void EventFanout::removeDestination(const string &name) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    sDestinations.erase(name);
+    sDestinationCount.store(sDestinations.size(), std::memory_order_release);
+}
+
+bool EventFanout::hasDestinations() {
+    return sDestinationCount.load(std::memory_order_acquire) > 0;
+}
+
+void EventFanout::dispatch(const std::shared_ptr<const SerializedEvent> &event) {
+    enqueue(event, false);
+}
+
+void EventFanout::replay(const std::shared_ptr<const SerializedEvent> &event) {
+    enqueue(event, true);
+}
+
+void EventFanout::pump() {
+    if (!hasDestinations()) return;
+    sendReady();
+}
+
+void EventFanout::flush() {
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        for (std::map<string, DestinationPtr>::const_iterator iterator = sDestinations.begin(); iterator != sDestinations.end(); ++iterator) {
+            if (!iterator->second->events.empty()) {
+                iterator->second->flushRequested = true;
+            }
+        }
+    }
+    sendReady();
+}
+
+void EventFanout::clear() {
+    std::lock_guard<std::mutex> lock(sMutex);
+    for (std::map<string, DestinationPtr>::const_iterator iterator = sDestinations.begin(); iterator != sDestinations.end(); ++iterator) {
+        // 正在发送的批次完成后按序号移除，已清空的队列不受影响
+        iterator->second->events.clear();
+        iterator->second->flushRequested = false;
+    }
+}
+
+void EventFanout::acknowledge(const string &name, const std::vector<uint64_t> &eventIds) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    std::map<string, DestinationPtr>::const_iterator found = sDestinations.find(name);
+    if (found == sDestinations.end()) return;
+    Destination &destination = *found->second;
+    for (std::vector<uint64_t>::const_iterator iterator = eventIds.begin(); iterator != eventIds.end(); ++iterator) {
+        destination.acked.add(*iterator);
+    }
+    // 只移除本次确认的事件，不依赖去重索引，避免误判导致未确认的事件被移除
+    std::set<uint64_t> ids(eventIds.begin(), eventIds.end());
+    std::deque<QueuedView> remaining;
+    for (std::deque<QueuedView>::const_iterator iterator = destination.events.begin(); iterator != destination.events.end(); ++iterator) {
+        if (ids.find(iterator->view.eventId()) == ids.end()) {
+            remaining.push_back(*iterator);
+        } else {
+            ++destination.ackedEvents;
+        }
+    }
+    destination.events.swap(remaining);
+}
+
+bool EventFanout::saveDedupIndex(const string &name, string *output) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    std::map<string, DestinationPtr>::const_iterator iterator = sDestinations.find(name);
+    if (iterator == sDestinations.end() || !output) return false;
+    iterator->second->acked.save(output);
+    return true;
+}
+
+bool EventFanout::restoreDedupIndex(const string &name, const string &data) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    std::map<string, DestinationPtr>::const_iterator iterator = sDestinations.find(name);
+    return iterator != sDestinations.end() && iterator->second->acked.restore(data);
+}
+
+DestinationStats EventFanout::getStats(const string &name) {
+    DestinationStats stats;
+    std::lock_guard<std::mutex> lock(sMutex);
+    std::map<string, DestinationPtr>::const_iterator iterator = sDestinations.find(name);
+    if (iterator == sDestinations.end()) return stats;
+    const Destination &destination = *iterator->second;
+    stats.pendingEvents = destination.events.size();
+    stats.ackedEvents = destination.ackedEvents;
+    stats.failedBatches = destination.failedBatches;
+    stats.skippedReplays = destination.skippedReplays;
+    stats.dedupMemoryBytes = destination.acked.memoryBytes();
+    stats.dedupFalsePositiveRate = destination.acked.expectedFalsePositiveRate();
+    return stats;
+}
+
+size_t EventFanout::pendingCount(const string &name) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    std::map<string, DestinationPtr>::const_iterator iterator = sDestinations.find(name);
+    return iterator == sDestinations.end() ? 0 : iterator->second->events.size();
+}
@@ -0,0 +1,341 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../include/EventLanes.h"
+#include "../include/SensorsAnalytics.h"
+#include "PlatformBridge.h"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace sensorsdata;
+
+namespace {
+    struct QueuedEvent {
+        string eventName;
+        EventKey eventKey;
+        ObjectNode properties;
+        // 存在其它目的地时为共享的序列化结果，此时 properties 为空
+        std::shared_ptr<const SerializedEvent> serialized;
+        // 入队时间，发送时作为事件时间，0 表示由原生 SDK 使用发送时的时间
+        int64_t eventTimeMillis;
+
+        QueuedEvent() : eventTimeMillis(0) {}
+    };
+
+    typedef std::deque<QueuedEvent> Batch;
+    typedef std::shared_ptr<Batch> BatchPtr;
+
+    struct Lane {
+        LaneConfig config;
+        std::deque<QueuedEvent> events;
+        // 已达到发送阈值、由 WorkScheduler 逐个发送的批次，按入队顺序排列
+        std::vector<BatchPtr> deferred;
+        uint64_t dropped;
+
+        Lane() : dropped(0) {}
+    };
+
+    // 保护所有队列，包括 deferred 中的批次
+    std::mutex sLanesMutex;
+
+    Lane *lanes() {
+        static Lane sLanes[kEventPriorityCount];
+        static bool initialized = false;
+        if (!initialized) {
+            sLanes[kEventPriorityCritical].config = LaneConfig(0, 1, kLaneDropNewest, true);
+            sLanes[kEventPriorityNormal].config = LaneConfig(1000, 1, kLaneDropOldest, false);
+            sLanes[kEventPriorityBulk].config = LaneConfig(2000, 100, kLaneDropOldest, false);
+            initialized = true;
+        }
+        return sLanes;
+    }
+
+    bool isValid(EventPriority priority) {
+        return priority >= 0 && priority < kEventPriorityCount;
+    }
+
+    int64_t nowMillis() {
+        return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    void deliverEvent(const QueuedEvent &event) {
+        if (event.serialized) {
+            platform::track(*event.serialized, event.eventTimeMillis);
+        } else {
+            platform::track(event.eventName.c_str(), event.properties, event.eventKey, event.eventTimeMillis);
+        }
+    }
+
+    /**
+     * 将取出的事件发送给原生 SDK，调用方不能持有 sLanesMutex
+     * @param events 取出的事件
+     * @param flushAfterDeliver 发送后是否立即上报
+     */
+    void deliver(const Batch &events, bool flushAfterDeliver) {
+        if (events.empty()) return;
+        StatsRecorder::addQueueDepth(-static_cast<int64_t>(events.size()));
+        for (Batch::const_iterator iterator = events.begin(); iterator != events.end(); ++iterator) {
+            deliverEvent(*iterator);
+        }
+        if (flushAfterDeliver) {
+            platform::flush();
+        }
+    }
+
+    /**
+     * 提交按帧预算逐个发送的任务，batch 需已加入 Lane::deferred，调用方不能持有 sLanesMutex。
+     * drain 与 clear 会直接取走 batch 中剩余的事件，此时任务在下一个步骤结束
+     */
+    void postDeferred(EventPriority priority, const BatchPtr &batch, bool flushAfterDeliver) {
+        WorkScheduler::post([priority, batch, flushAfterDeliver]() -> bool {
+            QueuedEvent event;
+            bool hasEvent = false;
+            bool done;
+            {
+                std::lock_guard<std::mutex> lock(sLanesMutex);
+                if (!batch->empty()) {
+                    event = std::move(batch->front());
+                    batch->pop_front();
+                    hasEvent = true;
+                }
+                done = batch->empty();
+                if (done) {
+                    std::vector<BatchPtr> &deferred = lanes()[priority].deferred;
+                    deferred.erase(std::remove(deferred.begin(), deferred.end(), batch), deferred.end());
+                }
+            }
+            if (hasEvent) {
+                StatsRecorder::addQueueDepth(-1);
+                // 每个步骤发送一个事件，避免整批事件的序列化与 JNI/ObjC 调用集中在同一帧
+                deliverEvent(event);
+                if (done && flushAfterDeliver) {
+                    platform::flush();
+                }
+            }
+            return done;
+        });
+    }
+}
+
+void EventLanes::setLaneConfig(EventPriority priority, const LaneConfig &config) {
+    if (!isValid(priority)) return;
+    std::lock_guard<std::mutex> lock(sLanesMutex);
+    lanes()[priority].config = config;
+}
+
+LaneConfig EventLanes::getLaneConfig(EventPriority priority) {
+    if (!isValid(priority)) return LaneConfig();
+    std::lock_guard<std::mutex> lock(sLanesMutex);
+    return lanes()[priority].config;
+}
+
+/**
+ * 将事件加入对应的队列
+ * @param eventName 事件名
+ * @param eventKey 驻留的事件名，未驻留时无效
+ * @param properties 事件属性
+ * @param serialized 已序列化的事件，不为空时忽略 properties
+ * @param priority 优先级
+ */
+static void enqueueEvent(const char *eventName, const EventKey &eventKey, const ObjectNode &properties,
+                         const std::shared_ptr<const SerializedEvent> &serialized, EventPriority priority) {
+    if (!eventName || !isValid(priority)) return;
+    Batch ready;
+    BatchPtr deferred;
+    bool deliverDirectly = false;
+    bool flushAfterDeliver;
+    {
+        std::lock_guard<std::mutex> lock(sLanesMutex);
+        Lane &lane = lanes()[priority];
+        flushAfterDeliver = lane.config.flushAfterDeliver;
+        if (lane.config.flushThreshold <= 1 && lane.events.empty() && lane.deferred.empty()) {
+            // 立即发送且队列中没有积压时，不复制事件属性
+            deliverDirectly = true;
+        } else {
+            if (lane.config.capacity != 0 && lane.events.size() >= lane.config.capacity) {
+                ++lane.dropped;
+                StatsRecorder::recordDroppedEvent();
+                if (lane.config.dropPolicy == kLaneDropNewest) {
+                    return;
+                }
+                lane.events.pop_front();
+                StatsRecorder::addQueueDepth(-1);
+            }
+            lane.events.push_back(QueuedEvent());
+            QueuedEvent &queued = lane.events.back();
+            queued.eventName = eventName;
+            queued.eventKey = eventKey;
+            // 记录 track 时的时间，避免原生 SDK 以发送时的时间作为事件时间
+            queued.eventTimeMillis = nowMillis();
+            if (serialized) {
+                queued.serialized = serialized;
+            } else {
+                queued.properties.mergeFrom(properties);
+            }
+            StatsRecorder::addQueueDepth(1);
+            if (lane.events.size() < lane.config.flushThreshold) {
+                return;
+            }
+            if (lane.events.size() > 1 && WorkScheduler::isRunning()) {
+                deferred.reset(new Batch());
+                deferred->swap(lane.events);
+                lane.deferred.push_back(deferred);
+            } else {
+                ready.swap(lane.events);
+            }
+        }
+    }
+
+    if (deliverDirectly) {
+        if (serialized) {
+            platform::track(*serialized);
+        } else {
+            platform::track(eventName, properties, eventKey);
+        }
+        if (flushAfterDeliver) {
+            platform::flush();
+        }
+    } else if (deferred) {
+        postDeferred(priority, deferred, flushAfterDeliver);
+    } else {
+        deliver(ready, flushAfterDeliver);
+    }
+}
+
+void EventLanes::enqueue(const char *eventName, const ObjectNode &properties, EventPriority priority) {
+    enqueueEvent(eventName, EventKey(), properties, std::shared_ptr<const SerializedEvent>(), priority);
+}
+
+void EventLanes::enqueue(const EventKey &eventKey, const ObjectNode &properties, EventPriority priority) {
+    if (!eventKey.isValid()) return;
+    enqueueEvent(eventKey.name().c_str(), eventKey, properties, std::shared_ptr<const SerializedEvent>(), priority);
+}
+
+void EventLanes::enqueue(const std::shared_ptr<const SerializedEvent> &event, EventPriority priority) {
+    if (!event) return;
+    enqueueEvent(event->eventName().c_str(), event->eventKey(), ObjectNode(), event, priority);
+}
+
+void EventLanes::drain(EventPriority priority) {
+    if (!isValid(priority)) return;
+    Batch ready;
+    bool flushAfterDeliver;
+    {
+        std::lock_guard<std::mutex> lock(sLanesMutex);
+        Lane &lane = lanes()[priority];
+        flushAfterDeliver = lane.config.flushAfterDeliver;
+        // 先取走 WorkScheduler 尚未发送的批次，保持入队顺序
+        for (std::vector<BatchPtr>::const_iterator iterator = lane.deferred.begin(); iterator != lane.deferred.end(); ++iterator) {
+            std::move((*iterator)->begin(), (*iterator)->end(), std::back_inserter(ready));
+            (*iterator)->clear();
+        }
+        lane.deferred.clear();
+        std::move(lane.events.begin(), lane.events.end(), std::back_inserter(ready));
+        lane.events.clear();
+    }
+    deliver(ready, flushAfterDeliver);
+}
+
+void EventLanes::drainAll() {
+    for (int priority = 0; priority < kEventPriorityCount; ++priority) {
+        drain(static_cast<EventPriority>(priority));
+    }
+}
+
+void EventLanes::clear() {
+    std::lock_guard<std::mutex> lock(sLanesMutex);
+    for (int priority = 0; priority < kEventPriorityCount; ++priority) {
+        Lane &lane = lanes()[priority];
+        int64_t removed = static_cast<int64_t>(lane.events.size());
+        for (std::vector<BatchPtr>::const_iterator iterator = lane.deferred.begin(); iterator != lane.deferred.end(); ++iterator) {
+            removed += static_cast<int64_t>((*iterator)->size());
+            (*iterator)->clear();
+        }
+        lane.deferred.clear();
+        lane.events.clear();
+        StatsRecorder::addQueueDepth(-removed);
+    }
+}
+
+size_t EventLanes::pendingCount(EventPriority priority) {
+    if (!isValid(priority)) return 0;
+    std::lock_guard<std::mutex> lock(sLanesMutex);
+    const Lane &lane = lanes()[priority];
+    size_t count = lane.events.size();
+    for (std::vector<BatchPtr>::const_iterator iterator = lane.deferred.begin(); iterator != lane.deferred.end(); ++iterator) {
+        count += (*iterator)->size();
+    }
+    return count;
+}
+
+uint64_t EventLanes::droppedCount(EventPriority priority) {
+    if (!isValid(priority)) return 0;
+    std::lock_guard<std::mutex> lock(sLanesMutex);
+    return lanes()[priority].dropped;
+}
+
+void SensorsAnalytics::warmUp() {
+    if (!platform::warmUp()) return;
+    ObjectNode::warmUp();
+    // 创建各个队列及其默认配置
+    std::lock_guard<std::mutex> lock(sLanesMutex);
+    lanes();
+}
+
+void SensorsAnalytics::track(const char *eventName, const ObjectNode &properties) {
+    track(eventName, properties, kEventPriorityNormal);
+}
+
+/**
+ * 存在其它目的地时只序列化一次，原生 SDK 的队列与各目的地共享同一份序列化结果
+ */
+static void fanOut(const char *eventName, const EventKey &eventKey, const ObjectNode &properties,
+                   EventPriority priority) {
+    std::shared_ptr<const SerializedEvent> event = SerializedEvent::create(eventName, eventKey, properties);
+    EventFanout::dispatch(event);
+    EventLanes::enqueue(event, priority);
+}
+
+void SensorsAnalytics::track(const char *eventName, const ObjectNode &properties, EventPriority priority) {
+    // 超出单个事件预算时丢弃，不做任何序列化与复制
+    if (!eventName || !PayloadGuard::acceptEvent(properties)) return;
+    if (EventFanout::hasDestinations()) {
+        fanOut(eventName, EventKey(), properties, priority);
+        return;
+    }
+    EventLanes::enqueue(eventName, properties, priority);
+}
+
+void SensorsAnalytics::track(const EventKey &eventKey, const ObjectNode &properties) {
+    track(eventKey, properties, kEventPriorityNormal);
+}
+
+void SensorsAnalytics::track(const EventKey &eventKey, const ObjectNode &properties, EventPriority priority) {
+    if (!eventKey.isValid() || !PayloadGuard::acceptEvent(properties)) return;
+    if (EventFanout::hasDestinations()) {
+        fanOut(eventKey.name().c_str(), eventKey, properties, priority);
+        return;
+    }
+    EventLanes::enqueue(eventKey, properties, priority);
+}
@@ -0,0 +1,63 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../include/IdentityCache.h"
+#include <memory>
+#include <mutex>
+
+using namespace sensorsdata;
+
+// 当前快照，通过 std::atomic_load/atomic_store 读写，未加载时为空
+static std::shared_ptr<const IdentitySnapshot> sCurrent;
+// 串行化写操作
+static std::mutex sWriteMutex;
+
+/**
+ * 未加载时返回的空快照
+ */
+static const std::shared_ptr<const IdentitySnapshot> &emptySnapshot() {
+    static const std::shared_ptr<const IdentitySnapshot> *empty =
+            new std::shared_ptr<const IdentitySnapshot>(new IdentitySnapshot());
+    return *empty;
+}
+
+bool IdentityCache::isLoaded() {
+    return std::atomic_load(&sCurrent) != NULL;
+}
+
+std::shared_ptr<const IdentitySnapshot> IdentityCache::current() {
+    std::shared_ptr<const IdentitySnapshot> snapshot = std::atomic_load(&sCurrent);
+    return snapshot ? snapshot : emptySnapshot();
+}
+
+void IdentityCache::load(const IdentitySnapshot &snapshot) {
+    std::lock_guard<std::mutex> lock(sWriteMutex);
+    if (!std::atomic_load(&sCurrent)) {
+        std::atomic_store(&sCurrent, std::shared_ptr<const IdentitySnapshot>(new IdentitySnapshot(snapshot)));
+    }
+}
+
+void IdentityCache::update(const IdentitySnapshot &snapshot) {
+    std::lock_guard<std::mutex> lock(sWriteMutex);
+    std::shared_ptr<const IdentitySnapshot> current = std::atomic_load(&sCurrent);
+    if (current && current->distinctId == snapshot.distinctId && current->loginId == snapshot.loginId &&
+        current->anonymousId == snapshot.anonymousId) {
+        return;
+    }
+    std::atomic_store(&sCurrent, std::shared_ptr<const IdentitySnapshot>(new IdentitySnapshot(snapshot)));
+}
@@ -0,0 +1,136 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../include/InternTable.h"
+#include "../include/ObjectNode.h"
+#include <atomic>
+#include <map>
+#include <mutex>
+
+using namespace sensorsdata;
+
+namespace {
+    struct Entry {
+        string name;
+        string json;
+        std::atomic<void *> platformString;
+
+        Entry() : platformString(NULL) {}
+    };
+
+    // 每个分块的条目数
+    const uint32_t kChunkSize = 256;
+    // 分块个数上限，共可驻留 kChunkSize * kMaxChunks - 1 个字符串
+    const uint32_t kMaxChunks = 1024;
+
+    std::atomic<Entry *> sChunks[kMaxChunks];
+    // 已发布的条目数，ID 小于该值的条目可以无锁读取
+    std::atomic<uint32_t> sCount(1);
+
+    // EventKey、PropertyKey 可能在其它编译单元的静态初始化阶段构造，以下对象在首次使用时创建且不析构，
+    // 与静态初始化及析构顺序无关
+
+    // 保护 ids() 以及新条目的写入
+    std::mutex &internMutex() {
+        static std::mutex *mutex = new std::mutex();
+        return *mutex;
+    }
+
+    std::map<string, uint32_t> &ids() {
+        static std::map<string, uint32_t> *ids = new std::map<string, uint32_t>();
+        return *ids;
+    }
+
+    const string &emptyString() {
+        static const string *empty = new string();
+        return *empty;
+    }
+
+    Entry *entryOf(uint32_t id) {
+        if (id == InternTable::kInvalidId || id >= sCount.load(std::memory_order_acquire)) {
+            return NULL;
+        }
+        return &sChunks[id / kChunkSize].load(std::memory_order_acquire)[id % kChunkSize];
+    }
+}
+
+uint32_t InternTable::intern(const char *value) {
+    if (!value) return kInvalidId;
+    string name(value);
+    std::lock_guard<std::mutex> lock(internMutex());
+    std::map<string, uint32_t> &nameIds = ids();
+    std::map<string, uint32_t>::const_iterator iterator = nameIds.find(name);
+    if (iterator != nameIds.end()) {
+        return iterator->second;
+    }
+
+    uint32_t id = sCount.load(std::memory_order_relaxed);
+    uint32_t chunk = id / kChunkSize;
+    if (chunk >= kMaxChunks) {
+        return kInvalidId;
+    }
+    Entry *entries = sChunks[chunk].load(std::memory_order_relaxed);
+    if (entries == NULL) {
+        entries = new Entry[kChunkSize];
+        sChunks[chunk].store(entries, std::memory_order_release);
+    }
+    Entry &entry = entries[id % kChunkSize];
+    entry.name = name;
+    entry.json = ObjectNode::ValueNode(name).json();
+    nameIds[name] = id;
+    // 条目写入完成后再发布
+    sCount.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+const string &InternTable::name(uint32_t id) {
+    Entry *entry = entryOf(id);
+    return entry ? entry->name : emptyString();
+}
+
+const string &InternTable::json(uint32_t id) {
+    Entry *entry = entryOf(id);
+    return entry ? entry->json : emptyString();
+}
+
+void *InternTable::platformString(uint32_t id) {
+    Entry *entry = entryOf(id);
+    return entry ? entry->platformString.load(std::memory_order_acquire) : NULL;
+}
+
+bool InternTable::setPlatformString(uint32_t id, void *value) {
+    Entry *entry = entryOf(id);
+    if (entry == NULL) return false;
+    void *expected = NULL;
+    return entry->platformString.compare_exchange_strong(expected, value, std::memory_order_acq_rel);
+}
+
+size_t PropertyName::jsonSize() const {
+    if (key.isValid()) {
+        return InternTable::json(key.id).length();
+    }
+    return ObjectNode::ValueNode::stringJsonSize(value);
+}
+
+void PropertyName::appendJson(string *buffer) const {
+    if (key.isValid()) {
+        *buffer += InternTable::json(key.id);
+    } else {
+        ObjectNode::ValueNode::dumpString(value, buffer);
+    }
+}
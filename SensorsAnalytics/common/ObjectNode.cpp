@@ -16,70 +16,184 @@
  */
 
 #include "../include/ObjectNode.h"
+#include "../include/PayloadBudget.h"
 #include <sstream>
 
 using namespace sensorsdata;
 
+/**
+ * 创建字符串属性，超出预算时截断，避免超长字符串被序列化后再由原生 SDK 截断
+ * @param value 字符串
+ * @return 属性值
+ */
+static ObjectNode::ValueNode truncatedStringNode(const char *value) {
+    string stringValue(value);
+    PayloadGuard::truncateString(&stringValue);
+    return ObjectNode::ValueNode(stringValue);
+}
+
+/**
+ * 创建 List 属性，超出预算时截断
+ * @param value List
+ * @return 属性值
+ */
+static ObjectNode::ValueNode truncatedListNode(const std::vector<string> &value) {
+    std::vector<string> listValue(value);
+    PayloadGuard::truncateList(&listValue);
+    return ObjectNode::ValueNode(listValue);
+}
+
 void ObjectNode::setNumber(const char *propertyName, double value) {
     if (!propertyName) return;
-    propertiesMap[string(propertyName)] = ValueNode(value);
+    putValue(PropertyName(propertyName), ValueNode(value));
 }
 
 void ObjectNode::setNumber(const char *propertyName, int32_t value) {
     if (!propertyName) return;
-    propertiesMap[string(propertyName)] = ValueNode(static_cast<int64_t>(value));
+    putValue(PropertyName(propertyName), ValueNode(static_cast<int64_t>(value)));
 }
 
 void ObjectNode::setNumber(const char *propertyName, int64_t value) {
     if (!propertyName) return;
-    propertiesMap[string(propertyName)] = ValueNode(value);
+    putValue(PropertyName(propertyName), ValueNode(value));
 }
 
 void ObjectNode::setString(const char *propertyName, const char *value) {
     if (!propertyName || !value) return;
-    propertiesMap[string(propertyName)] = ValueNode(string(value));
+    putValue(PropertyName(propertyName), truncatedStringNode(value));
 }
 
 void ObjectNode::setBool(const char *propertyName, bool value) {
     if (!propertyName) return;
-    propertiesMap[string(propertyName)] = ValueNode(value);
+    putValue(PropertyName(propertyName), ValueNode(value));
 }
 
 void ObjectNode::setList(const char *propertyName, const std::vector<string> &value) {
     if (!propertyName) return;
-    propertiesMap[string(propertyName)] = ValueNode(value);
+    putValue(PropertyName(propertyName), truncatedListNode(value));
 }
 
 void ObjectNode::setDateTime(const char *propertyName, const time_t seconds, int milliseconds) {
     if (!propertyName) return;
-    propertiesMap[string(propertyName)] = ValueNode(seconds, milliseconds);
+    putValue(PropertyName(propertyName), ValueNode(seconds, milliseconds));
 }
 
 void ObjectNode::setDateTime(const char *propertyName, const char *value) {
     if (!propertyName || !value) return;
-    propertiesMap[string(propertyName)] = ValueNode(string(value));
+    putValue(PropertyName(propertyName), ValueNode(string(value)));
+}
+
+void ObjectNode::setNumber(const PropertyKey &propertyKey, double value) {
+    if (!propertyKey.isValid()) return;
+    putValue(PropertyName(propertyKey), ValueNode(value));
+}
+
+void ObjectNode::setNumber(const PropertyKey &propertyKey, int32_t value) {
+    if (!propertyKey.isValid()) return;
+    putValue(PropertyName(propertyKey), ValueNode(static_cast<int64_t>(value)));
+}
+
+void ObjectNode::setNumber(const PropertyKey &propertyKey, int64_t value) {
+    if (!propertyKey.isValid()) return;
+    putValue(PropertyName(propertyKey), ValueNode(value));
+}
+
+void ObjectNode::setString(const PropertyKey &propertyKey, const char *value) {
+    if (!propertyKey.isValid() || !value) return;
+    putValue(PropertyName(propertyKey), truncatedStringNode(value));
+}
+
+void ObjectNode::setBool(const PropertyKey &propertyKey, bool value) {
+    if (!propertyKey.isValid()) return;
+    putValue(PropertyName(propertyKey), ValueNode(value));
+}
+
+void ObjectNode::setList(const PropertyKey &propertyKey, const std::vector<string> &value) {
+    if (!propertyKey.isValid()) return;
+    putValue(PropertyName(propertyKey), truncatedListNode(value));
+}
+
+void ObjectNode::setDateTime(const PropertyKey &propertyKey, const time_t seconds, int milliseconds) {
+    if (!propertyKey.isValid()) return;
+    putValue(PropertyName(propertyKey), ValueNode(seconds, milliseconds));
 }
 
 void ObjectNode::clear() {
     propertiesMap.clear();
+    entriesBytes = 0;
+}
+
+void ObjectNode::putValue(const PropertyName &propertyName, const ValueNode &value) {
+    // "key": 占用转义后 key 的长度 + 3 个字节
+    size_t keyBytes = propertyName.jsonSize() + 1;
+    std::map<PropertyName, ValueNode>::iterator iterator = propertiesMap.find(propertyName);
+    if (iterator != propertiesMap.end()) {
+        size_t oldBytes = keyBytes + iterator->second.jsonSize();
+        iterator->second = value;
+        if (entriesBytes < oldBytes) {
+            // 旧值是直接写入 propertiesMap 的，未计入 entriesBytes，重新计算
+            recomputeEntriesBytes();
+            return;
+        }
+        entriesBytes -= oldBytes;
+    } else {
+        propertiesMap.insert(std::make_pair(propertyName, value));
+    }
+    entriesBytes += keyBytes + value.jsonSize();
+}
+
+void ObjectNode::recomputeEntriesBytes() {
+    entriesBytes = 0;
+    for (std::map<PropertyName, ValueNode>::const_iterator iterator = propertiesMap.begin(); iterator != propertiesMap.end(); ++iterator) {
+        entriesBytes += iterator->first.jsonSize() + 1 + iterator->second.jsonSize();
+    }
+}
+
+size_t ObjectNode::payloadSize() const {
+    size_t count = propertiesMap.size();
+    // '{' + '}' + 属性之间的 ','
+    return entriesBytes + 2 + (count > 0 ? count - 1 : 0);
 }
 
 void ObjectNode::dumpNode(const ObjectNode &node, string *buffer) {
     *buffer += '{';
     bool first = true;
 
-    for (std::map<string, ValueNode>::const_iterator iterator = node.propertiesMap.begin(); iterator != node.propertiesMap.end(); ++iterator) {
+    for (std::map<PropertyName, ValueNode>::const_iterator iterator = node.propertiesMap.begin(); iterator != node.propertiesMap.end(); ++iterator) {
         if (first) {
             first = false;
         } else {
             *buffer += ',';
         }
-        *buffer += '"' + iterator->first + "\":";
-        ValueNode::toStr(iterator->second, buffer);
+        iterator->first.appendJson(buffer);
+        *buffer += ':';
+        // 直接拼接 setX 时生成的片段，未修改的属性不会重复序列化
+        *buffer += iterator->second.json();
     }
     *buffer += '}';
 }
 
+size_t ObjectNode::ValueNode::stringJsonSize(const string &value) {
+    // 与 dumpString 转义的字符保持一致
+    size_t size = value.length() + 2;
+    for (std::string::size_type i = 0; i < value.length(); ++i) {
+        switch (value[i]) {
+            case '"':
+            case '\\':
+            case '\b':
+            case '\f':
+            case '\n':
+            case '\r':
+            case '\t':
+                ++size;
+                break;
+            default:
+                break;
+        }
+    }
+    return size;
+}
+
 void ObjectNode::ValueNode::dumpString(const string &value, string *buffer) {
     *buffer += '"';
     for (std::string::size_type i = 0; i < value.length(); ++i) {
@@ -154,55 +268,44 @@ void ObjectNode::ValueNode::dumpDateTime(const time_t &seconds, int milliseconds
 
 string ObjectNode::toJson(const ObjectNode &node) {
     string buffer;
+    buffer.reserve(node.payloadSize());
     dumpNode(node, &buffer);
     return buffer;
 }
 
+void ObjectNode::warmUp() {
+    ObjectNode node;
+    node.setNumber("number", 0.5);
+    node.setNumber("int", static_cast<int64_t>(1));
+    node.setDateTime("datetime", time(NULL), 0);
+    toJson(node);
+}
+
 ObjectNode::ValueNode::ValueNode(double value) : nodeType(NUMBER) {
-    valueData.numberValue = value;
+    dumpNumber(value, &jsonFragment);
 }
 
 ObjectNode::ValueNode::ValueNode(int64_t value) : nodeType(INT) {
-    valueData.intValue = value;
+    dumpNumber(value, &jsonFragment);
 }
 
-ObjectNode::ValueNode::ValueNode(const string &value) : nodeType(STRING), stringData(value) {}
+ObjectNode::ValueNode::ValueNode(const string &value) : nodeType(STRING) {
+    dumpString(value, &jsonFragment);
+}
 
-ObjectNode::ValueNode::ValueNode(bool value) : nodeType(BOOL) {
-    valueData.boolValue = value;
+ObjectNode::ValueNode::ValueNode(bool value) : nodeType(BOOL), jsonFragment(value ? "true" : "false") {
 }
 
-ObjectNode::ValueNode::ValueNode(const std::vector<string> &value) : nodeType(LIST), listData(value) {}
+ObjectNode::ValueNode::ValueNode(const std::vector<string> &value) : nodeType(LIST) {
+    dumpList(value, &jsonFragment);
+}
 
 ObjectNode::ValueNode::ValueNode(time_t seconds, int milliseconds) : nodeType(DATETIME) {
-    valueData.datetimeValue.seconds = seconds;
-    valueData.datetimeValue.milliseconds = milliseconds;
+    dumpDateTime(seconds, milliseconds, &jsonFragment);
 }
 
 void ObjectNode::ValueNode::toStr(const ObjectNode::ValueNode &node, string *buffer) {
-    switch (node.nodeType) {
-        case NUMBER:
-            dumpNumber(node.valueData.numberValue, buffer);
-            break;
-        case INT:
-            dumpNumber(node.valueData.intValue, buffer);
-            break;
-        case STRING:
-            dumpString(node.stringData, buffer);
-            break;
-        case LIST:
-            dumpList(node.listData, buffer);
-            break;
-        case BOOL:
-            *buffer += (node.valueData.boolValue ? "true" : "false");
-            break;
-        case DATETIME:
-            dumpDateTime(node.valueData.datetimeValue.seconds,
-                         node.valueData.datetimeValue.milliseconds, buffer);
-            break;
-        default:
-            break;
-    }
+    *buffer += node.jsonFragment;
 }
 
 void ObjectNode::ValueNode::dumpNumber(double value, string *buffer) {
@@ -218,9 +321,9 @@ void ObjectNode::ValueNode::dumpNumber(int64_t value, string *buffer) {
 }
 
 void ObjectNode::mergeFrom(const ObjectNode &anotherNode) {
-    for (std::map<string, ValueNode>::const_iterator
+    for (std::map<PropertyName, ValueNode>::const_iterator
                  iterator = anotherNode.propertiesMap.begin();
          iterator != anotherNode.propertiesMap.end(); ++iterator) {
-        propertiesMap[iterator->first] = iterator->second;
+        putValue(iterator->first, iterator->second);
     }
 }
@@ -0,0 +1,133 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../include/PayloadBudget.h"
+#include "../include/ObjectNode.h"
+#include "../include/SdkStats.h"
+#include <atomic>
+
+using namespace sensorsdata;
+
+static std::atomic<size_t> sMaxStringBytes(PayloadBudget().maxStringBytes);
+static std::atomic<size_t> sMaxListItems(PayloadBudget().maxListItems);
+static std::atomic<size_t> sMaxListBytes(PayloadBudget().maxListBytes);
+static std::atomic<size_t> sMaxEventBytes(PayloadBudget().maxEventBytes);
+
+static std::atomic<uint64_t> sTruncatedStrings(0);
+static std::atomic<uint64_t> sTruncatedLists(0);
+static std::atomic<uint64_t> sRejectedEvents(0);
+
+/**
+ * 在不超过 maxBytes 的前提下截断 UTF-8 字符串，回退到完整字符的边界
+ * @param value 字符串
+ * @param maxBytes 最大字节数
+ * @return 是否发生截断
+ */
+static bool truncateUtf8(string *value, size_t maxBytes) {
+    if (maxBytes == 0 || value->length() <= maxBytes) {
+        return false;
+    }
+    size_t end = maxBytes;
+    // 0b10xxxxxx 为多字节字符的后续字节，不能作为截断位置
+    while (end > 0 && (static_cast<unsigned char>((*value)[end]) & 0xC0) == 0x80) {
+        --end;
+    }
+    value->resize(end);
+    return true;
+}
+
+void PayloadGuard::setBudget(const PayloadBudget &budget) {
+    sMaxStringBytes.store(budget.maxStringBytes, std::memory_order_relaxed);
+    sMaxListItems.store(budget.maxListItems, std::memory_order_relaxed);
+    sMaxListBytes.store(budget.maxListBytes, std::memory_order_relaxed);
+    sMaxEventBytes.store(budget.maxEventBytes, std::memory_order_relaxed);
+}
+
+PayloadBudget PayloadGuard::getBudget() {
+    PayloadBudget budget;
+    budget.maxStringBytes = sMaxStringBytes.load(std::memory_order_relaxed);
+    budget.maxListItems = sMaxListItems.load(std::memory_order_relaxed);
+    budget.maxListBytes = sMaxListBytes.load(std::memory_order_relaxed);
+    budget.maxEventBytes = sMaxEventBytes.load(std::memory_order_relaxed);
+    return budget;
+}
+
+PayloadStats PayloadGuard::getStats() {
+    PayloadStats stats;
+    stats.truncatedStrings = sTruncatedStrings.load(std::memory_order_relaxed);
+    stats.truncatedLists = sTruncatedLists.load(std::memory_order_relaxed);
+    stats.rejectedEvents = sRejectedEvents.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void PayloadGuard::resetStats() {
+    sTruncatedStrings.store(0, std::memory_order_relaxed);
+    sTruncatedLists.store(0, std::memory_order_relaxed);
+    sRejectedEvents.store(0, std::memory_order_relaxed);
+}
+
+bool PayloadGuard::truncateString(string *value) {
+    if (!value) return false;
+    if (truncateUtf8(value, sMaxStringBytes.load(std::memory_order_relaxed))) {
+        sTruncatedStrings.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool PayloadGuard::truncateList(std::vector<string> *value) {
+    if (!value) return false;
+    bool truncated = false;
+    size_t maxItems = sMaxListItems.load(std::memory_order_relaxed);
+    if (maxItems != 0 && value->size() > maxItems) {
+        value->resize(maxItems);
+        truncated = true;
+    }
+
+    size_t maxStringBytes = sMaxStringBytes.load(std::memory_order_relaxed);
+    size_t maxListBytes = sMaxListBytes.load(std::memory_order_relaxed);
+    // '[' + ']' + 元素之间的 ','，每个元素按转义后的长度计算
+    size_t listBytes = 2;
+    for (std::vector<string>::size_type i = 0; i < value->size(); ++i) {
+        string &item = (*value)[i];
+        if (truncateUtf8(&item, maxStringBytes)) {
+            truncated = true;
+        }
+        size_t itemBytes = ObjectNode::ValueNode::stringJsonSize(item) + (i > 0 ? 1 : 0);
+        if (maxListBytes != 0 && listBytes + itemBytes > maxListBytes) {
+            value->resize(i);
+            truncated = true;
+            break;
+        }
+        listBytes += itemBytes;
+    }
+
+    if (truncated) {
+        sTruncatedLists.fetch_add(1, std::memory_order_relaxed);
+    }
+    return truncated;
+}
+
+bool PayloadGuard::acceptEvent(const ObjectNode &properties) {
+    size_t maxEventBytes = sMaxEventBytes.load(std::memory_order_relaxed);
+    if (maxEventBytes == 0 || properties.payloadSize() <= maxEventBytes) {
+        return true;
+    }
+    sRejectedEvents.fetch_add(1, std::memory_order_relaxed);
+    StatsRecorder::recordDroppedEvent();
+    return false;
+}
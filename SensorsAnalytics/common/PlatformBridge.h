@@ -0,0 +1,91 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef COCOS2DX_SENSORS_PLATFORM_BRIDGE_H_
+#define COCOS2DX_SENSORS_PLATFORM_BRIDGE_H_
+
+#include "../include/ObjectNode.h"
+#include "../include/SerializedEvent.h"
+
+namespace sensorsdata {
+    /**
+     * 由 android/SensorsAnalytics.cpp 与 ios/SensorsAnalytics.mm 实现，
+     * 供 common 中的队列等模块直接调用原生 SDK
+     */
+    namespace platform {
+        /**
+         * 调用原生 SDK 的 track 接口
+         * @param eventName 事件名
+         * @param properties 事件属性
+         * @param eventKey 驻留的事件名，有效时使用缓存的平台字符串
+         * @param eventTimeMillis 事件时间，大于 0 时作为 $time 传给原生 SDK，否则由原生 SDK 使用当前时间
+         */
+        void track(const char *eventName, const ObjectNode &properties, const EventKey &eventKey = EventKey(),
+                   int64_t eventTimeMillis = 0);
+
+        /**
+         * 使用已序列化的事件调用原生 SDK 的 track 接口，不再重复序列化
+         * @param event 序列化后的事件
+         * @param eventTimeMillis 事件时间，大于 0 时作为 $time 传给原生 SDK，否则由原生 SDK 使用当前时间
+         */
+        void track(const SerializedEvent &event, int64_t eventTimeMillis = 0);
+
+        /**
+         * 调用原生 SDK 的 flush 接口
+         */
+        void flush();
+
+        /**
+         * 调用原生 SDK 的 profileSet 接口
+         * @param properties 用户属性
+         */
+        void profileSet(const ObjectNode &properties);
+
+        /**
+         * 调用原生 SDK 的 profileSetOnce 接口
+         * @param properties 用户属性
+         */
+        void profileSetOnce(const ObjectNode &properties);
+
+        /**
+         * 调用原生 SDK 的 itemSet 接口
+         * @param itemType item 类型
+         * @param itemId item ID
+         * @param properties item 属性
+         */
+        void itemSet(const char *itemType, const char *itemId, const ObjectNode &properties);
+
+        /**
+         * 预热平台相关的部分：获取 SDK 实例、查找原生方法、加载用户标识等，由 SensorsAnalytics::warmUp 调用
+         * @return 原生 SDK 是否已初始化，未初始化时不再预热其它部分
+         */
+        bool warmUp();
+
+        /**
+         * 在 cocos 的 Director 中每帧调用 WorkScheduler::tick，需在 cocos 主线程调用
+         */
+        void attachFrameTick();
+
+        /**
+         * 停止在 cocos 的 Director 中调用 WorkScheduler::tick
+         */
+        void detachFrameTick();
+    }
+}
+
+#endif // COCOS2DX_SENSORS_PLATFORM_BRIDGE_H_
@@ -0,0 +1,272 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../include/ProfileCoalescer.h"
+#include "../include/PayloadBudget.h"
+#include "../include/SensorsAnalytics.h"
+#include "PlatformBridge.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <stdlib.h>
+
+using namespace sensorsdata;
+
+namespace {
+    typedef std::pair<string, string> ItemKey;
+
+    struct PendingProfile {
+        ObjectNode setProperties;
+        ObjectNode setOnceProperties;
+        std::map<ItemKey, ObjectNode> items;
+
+        bool empty() const {
+            return setProperties.propertiesMap.empty() && setOnceProperties.propertiesMap.empty() && items.empty();
+        }
+    };
+
+    std::atomic<uint32_t> sWindowMillis(0);
+    // 保护 sPending、sWindowStart 与定时线程的状态
+    std::mutex sMutex;
+    PendingProfile sPending;
+    // 当前窗口中第一条数据的时间
+    int64_t sWindowStart = 0;
+
+    // 定时线程在窗口结束时发送数据，不依赖 WorkScheduler 是否启动
+    std::condition_variable sTimerCondition;
+    std::thread sTimer;
+    bool sTimerStopped = false;
+    std::once_flag sTimerFlag;
+
+    int64_t nowMillis() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * 标记窗口开始，调用方需持有 sMutex
+     */
+    void markWindowStart() {
+        if (sPending.empty()) {
+            sWindowStart = nowMillis();
+            sTimerCondition.notify_one();
+        }
+    }
+
+    /**
+     * 窗口是否已结束，调用方需持有 sMutex
+     */
+    bool isDue() {
+        return !sPending.empty() && nowMillis() - sWindowStart >= sWindowMillis.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * 发送取出的数据，调用方不能持有 sMutex
+     */
+    void send(const PendingProfile &pending) {
+        if (!pending.setProperties.propertiesMap.empty()) {
+            platform::profileSet(pending.setProperties);
+        }
+        if (!pending.setOnceProperties.propertiesMap.empty()) {
+            platform::profileSetOnce(pending.setOnceProperties);
+        }
+        for (std::map<ItemKey, ObjectNode>::const_iterator iterator = pending.items.begin();
+             iterator != pending.items.end(); ++iterator) {
+            platform::itemSet(iterator->first.first.c_str(), iterator->first.second.c_str(), iterator->second);
+        }
+    }
+
+    void timerLoop() {
+        std::unique_lock<std::mutex> lock(sMutex);
+        while (!sTimerStopped) {
+            uint32_t windowMillis = sWindowMillis.load(std::memory_order_relaxed);
+            if (sPending.empty() || windowMillis == 0) {
+                sTimerCondition.wait(lock);
+                continue;
+            }
+            int64_t remaining = sWindowStart + windowMillis - nowMillis();
+            if (remaining > 0) {
+                sTimerCondition.wait_for(lock, std::chrono::milliseconds(remaining));
+                continue;
+            }
+            PendingProfile ready;
+            std::swap(ready, sPending);
+            lock.unlock();
+            send(ready);
+            lock.lock();
+        }
+    }
+
+    /**
+     * 进程退出时停止定时线程，未发送的数据不再发送，原生 SDK 可能已不可用
+     */
+    void stopTimerAtExit() {
+        {
+            std::lock_guard<std::mutex> lock(sMutex);
+            sTimerStopped = true;
+        }
+        sTimerCondition.notify_all();
+        if (sTimer.joinable()) {
+            sTimer.join();
+        }
+    }
+
+    void startTimer() {
+        std::call_once(sTimerFlag, []() {
+            sTimer = std::thread(timerLoop);
+            atexit(stopTimerAtExit);
+        });
+    }
+
+    /**
+     * 在持有锁的情况下合并数据。合并后的记录会超过单条事件的大小上限时，先取出已合并的数据单独发送；
+     * 窗口结束时取出数据，在释放锁后发送
+     * @param update 待合并的属性
+     * @param record 返回 update 将要合并到的记录，不存在时返回 NULL
+     * @param merge 合并函数
+     */
+    template<class Record, class Merge>
+    void mergeAndSendIfDue(const ObjectNode &update, Record record, Merge merge) {
+        size_t maxEventBytes = PayloadGuard::getBudget().maxEventBytes;
+        PendingProfile overflow;
+        PendingProfile ready;
+        {
+            std::lock_guard<std::mutex> lock(sMutex);
+            const ObjectNode *existing = record(sPending);
+            if (maxEventBytes != 0 && existing != NULL && !existing->propertiesMap.empty() &&
+                existing->payloadSize() + update.payloadSize() > maxEventBytes) {
+                std::swap(overflow, sPending);
+            }
+            markWindowStart();
+            merge(sPending);
+            if (isDue()) {
+                std::swap(ready, sPending);
+            }
+        }
+        send(overflow);
+        send(ready);
+    }
+}
+
+void ProfileCoalescer::setWindow(uint32_t windowMillis) {
+    sWindowMillis.store(windowMillis, std::memory_order_relaxed);
+    if (windowMillis == 0) {
+        flush();
+        return;
+    }
+    startTimer();
+    // 唤醒定时线程，按新的窗口重新计算等待时间
+    sTimerCondition.notify_all();
+}
+
+bool ProfileCoalescer::isEnabled() {
+    return sWindowMillis.load(std::memory_order_relaxed) != 0;
+}
+
+bool ProfileCoalescer::profileSet(const ObjectNode &properties) {
+    if (!isEnabled()) return false;
+    mergeAndSendIfDue(properties, [](PendingProfile &pending) {
+        return &pending.setProperties;
+    }, [&properties](PendingProfile &pending) {
+        // 后写入的值生效
+        pending.setProperties.mergeFrom(properties);
+    });
+    return true;
+}
+
+bool ProfileCoalescer::profileSetOnce(const ObjectNode &properties) {
+    if (!isEnabled()) return false;
+    mergeAndSendIfDue(properties, [](PendingProfile &pending) {
+        return &pending.setOnceProperties;
+    }, [&properties](PendingProfile &pending) {
+        // 先写入的值生效：以新属性为底，再用已合并的属性覆盖
+        ObjectNode merged;
+        merged.mergeFrom(properties);
+        merged.mergeFrom(pending.setOnceProperties);
+        pending.setOnceProperties = merged;
+    });
+    return true;
+}
+
+bool ProfileCoalescer::itemSet(const char *itemType, const char *itemId, const ObjectNode &properties) {
+    if (!isEnabled() || !itemType || !itemId) return false;
+    ItemKey key(itemType, itemId);
+    mergeAndSendIfDue(properties, [&key](PendingProfile &pending) {
+        std::map<ItemKey, ObjectNode>::const_iterator iterator = pending.items.find(key);
+        return iterator != pending.items.end() ? &iterator->second : NULL;
+    }, [&key, &properties](PendingProfile &pending) {
+        pending.items[key].mergeFrom(properties);
+    });
+    return true;
+}
+
+void ProfileCoalescer::discardItem(const char *itemType, const char *itemId) {
+    if (!itemType || !itemId) return;
+    std::lock_guard<std::mutex> lock(sMutex);
+    sPending.items.erase(ItemKey(itemType, itemId));
+}
+
+void ProfileCoalescer::flushIfDue() {
+    PendingProfile ready;
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        if (!isDue()) {
+            return;
+        }
+        std::swap(ready, sPending);
+    }
+    send(ready);
+}
+
+void ProfileCoalescer::flush() {
+    PendingProfile ready;
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        if (sPending.empty()) {
+            return;
+        }
+        std::swap(ready, sPending);
+    }
+    send(ready);
+}
+
+void ProfileCoalescer::clear() {
+    std::lock_guard<std::mutex> lock(sMutex);
+    sPending = PendingProfile();
+}
+
+void SensorsAnalytics::profileSet(const ObjectNode &properties) {
+    if (!ProfileCoalescer::profileSet(properties)) {
+        platform::profileSet(properties);
+    }
+}
+
+void SensorsAnalytics::profileSetOnce(const ObjectNode &properties) {
+    if (!ProfileCoalescer::profileSetOnce(properties)) {
+        platform::profileSetOnce(properties);
+    }
+}
+
+void SensorsAnalytics::itemSet(const char *itemType, const char *itemId, const ObjectNode &properties) {
+    if (!ProfileCoalescer::itemSet(itemType, itemId, properties)) {
+        platform::itemSet(itemType, itemId, properties);
+    }
+}
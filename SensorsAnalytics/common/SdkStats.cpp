@@ -0,0 +1,228 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../include/SdkStats.h"
+#include "../include/SensorsAnalytics.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+using namespace sensorsdata;
+
+namespace {
+    /**
+     * 单个线程的计数器，只由所属线程写入，读取方使用 relaxed 读取
+     */
+    struct ThreadCounters {
+        std::atomic<uint64_t> calls[kStatsApiCount];
+        std::atomic<uint64_t> buckets[kStatsApiCount][kStatsPhaseCount][kStatsHistogramBuckets];
+        std::atomic<uint64_t> counts[kStatsApiCount][kStatsPhaseCount];
+        std::atomic<uint64_t> totalMicros[kStatsApiCount][kStatsPhaseCount];
+        std::atomic<uint64_t> maxMicros[kStatsApiCount][kStatsPhaseCount];
+        std::atomic<uint64_t> bytesSerialized;
+        std::atomic<uint64_t> droppedEvents;
+
+        ThreadCounters();
+
+        ~ThreadCounters();
+    };
+
+    // 只有所属线程写入，不需要 read-modify-write 原子操作
+    inline void increase(std::atomic<uint64_t> &counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    inline void clear(std::atomic<uint64_t> *counters, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            counters[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<bool> sEnabled(false);
+    std::atomic<int64_t> sQueueDepth(0);
+    // 保护 sThreads 与 sRetired
+    std::mutex sRegistryMutex;
+    std::vector<ThreadCounters *> sThreads;
+    // 已退出线程的计数器合并结果
+    SdkStats sRetired = SdkStats();
+    // 当前线程所在的 StatsScope 接口，kStatsApiCount 表示不在任何 StatsScope 内
+    thread_local int sCurrentApi = kStatsApiCount;
+
+    void mergeInto(const ThreadCounters &counters, SdkStats *stats) {
+        for (int api = 0; api < kStatsApiCount; ++api) {
+            ApiStats &apiStats = stats->apis[api];
+            apiStats.calls += counters.calls[api].load(std::memory_order_relaxed);
+            for (int phase = 0; phase < kStatsPhaseCount; ++phase) {
+                LatencyHistogram &histogram = apiStats.phases[phase];
+                for (int bucket = 0; bucket < kStatsHistogramBuckets; ++bucket) {
+                    histogram.buckets[bucket] += counters.buckets[api][phase][bucket].load(std::memory_order_relaxed);
+                }
+                histogram.count += counters.counts[api][phase].load(std::memory_order_relaxed);
+                histogram.totalMicros += counters.totalMicros[api][phase].load(std::memory_order_relaxed);
+                uint64_t maxMicros = counters.maxMicros[api][phase].load(std::memory_order_relaxed);
+                if (maxMicros > histogram.maxMicros) {
+                    histogram.maxMicros = maxMicros;
+                }
+            }
+        }
+        stats->bytesSerialized += counters.bytesSerialized.load(std::memory_order_relaxed);
+        stats->droppedEvents += counters.droppedEvents.load(std::memory_order_relaxed);
+    }
+
+    void clearCounters(ThreadCounters *counters) {
+        clear(counters->calls, kStatsApiCount);
+        clear(&counters->buckets[0][0][0], kStatsApiCount * kStatsPhaseCount * kStatsHistogramBuckets);
+        clear(&counters->counts[0][0], kStatsApiCount * kStatsPhaseCount);
+        clear(&counters->totalMicros[0][0], kStatsApiCount * kStatsPhaseCount);
+        clear(&counters->maxMicros[0][0], kStatsApiCount * kStatsPhaseCount);
+        counters->bytesSerialized.store(0, std::memory_order_relaxed);
+        counters->droppedEvents.store(0, std::memory_order_relaxed);
+    }
+
+    ThreadCounters::ThreadCounters() {
+        clearCounters(this);
+        std::lock_guard<std::mutex> lock(sRegistryMutex);
+        sThreads.push_back(this);
+    }
+
+    ThreadCounters::~ThreadCounters() {
+        std::lock_guard<std::mutex> lock(sRegistryMutex);
+        mergeInto(*this, &sRetired);
+        for (std::vector<ThreadCounters *>::iterator iterator = sThreads.begin(); iterator != sThreads.end(); ++iterator) {
+            if (*iterator == this) {
+                sThreads.erase(iterator);
+                break;
+            }
+        }
+    }
+
+    /**
+     * 获取当前线程的计数器，首次调用时注册
+     */
+    ThreadCounters &threadCounters() {
+        thread_local ThreadCounters counters;
+        return counters;
+    }
+
+    uint64_t nowMicros() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    int bucketOf(uint64_t micros) {
+        int bucket = 0;
+        while (micros != 0 && bucket < kStatsHistogramBuckets - 1) {
+            micros >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+}
+
+void StatsRecorder::setEnabled(bool enabled) {
+    sEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool StatsRecorder::isEnabled() {
+    return sEnabled.load(std::memory_order_relaxed);
+}
+
+void StatsRecorder::recordCall(StatsApi api) {
+    if (!isEnabled() || api < 0 || api >= kStatsApiCount) return;
+    increase(threadCounters().calls[api], 1);
+}
+
+void StatsRecorder::recordLatency(StatsApi api, StatsPhase phase, uint64_t micros) {
+    if (!isEnabled() || api < 0 || api >= kStatsApiCount || phase < 0 || phase >= kStatsPhaseCount) return;
+    ThreadCounters &counters = threadCounters();
+    increase(counters.buckets[api][phase][bucketOf(micros)], 1);
+    increase(counters.counts[api][phase], 1);
+    increase(counters.totalMicros[api][phase], micros);
+    if (micros > counters.maxMicros[api][phase].load(std::memory_order_relaxed)) {
+        counters.maxMicros[api][phase].store(micros, std::memory_order_relaxed);
+    }
+}
+
+void StatsRecorder::recordBytesSerialized(size_t bytes) {
+    if (!isEnabled()) return;
+    increase(threadCounters().bytesSerialized, bytes);
+}
+
+void StatsRecorder::recordDroppedEvent() {
+    if (!isEnabled()) return;
+    increase(threadCounters().droppedEvents, 1);
+}
+
+void StatsRecorder::addQueueDepth(int64_t delta) {
+    // 队列深度是多个线程共同维护的瞬时值，不区分是否开启统计
+    sQueueDepth.fetch_add(delta, std::memory_order_relaxed);
+}
+
+SdkStats StatsRecorder::snapshot() {
+    SdkStats stats = SdkStats();
+    {
+        std::lock_guard<std::mutex> lock(sRegistryMutex);
+        stats = sRetired;
+        for (std::vector<ThreadCounters *>::const_iterator iterator = sThreads.begin(); iterator != sThreads.end(); ++iterator) {
+            mergeInto(**iterator, &stats);
+        }
+    }
+    int64_t queueDepth = sQueueDepth.load(std::memory_order_relaxed);
+    stats.queueDepth = queueDepth > 0 ? static_cast<uint64_t>(queueDepth) : 0;
+    return stats;
+}
+
+void StatsRecorder::reset() {
+    std::lock_guard<std::mutex> lock(sRegistryMutex);
+    sRetired = SdkStats();
+    // 与所属线程的写入存在竞争时，最多丢失重置期间的少量计数
+    for (std::vector<ThreadCounters *>::iterator iterator = sThreads.begin(); iterator != sThreads.end(); ++iterator) {
+        clearCounters(*iterator);
+    }
+}
+
+StatsScope::StatsScope(StatsApi api) : previousApi(sCurrentApi) {
+    if (!StatsRecorder::isEnabled()) return;
+    sCurrentApi = api;
+    StatsRecorder::recordCall(api);
+}
+
+StatsScope::~StatsScope() {
+    sCurrentApi = previousApi;
+}
+
+StatsTimer::StatsTimer(StatsPhase phase) : phase(phase), api(sCurrentApi), startMicros(0) {
+    if (api != kStatsApiCount && StatsRecorder::isEnabled()) {
+        startMicros = nowMicros();
+    }
+}
+
+StatsTimer::~StatsTimer() {
+    if (startMicros != 0) {
+        StatsRecorder::recordLatency(static_cast<StatsApi>(api), phase, nowMicros() - startMicros);
+    }
+}
+
+void SensorsAnalytics::enableStats(bool enabled) {
+    StatsRecorder::setEnabled(enabled);
+}
+
+SdkStats SensorsAnalytics::getStats() {
+    return StatsRecorder::snapshot();
+}
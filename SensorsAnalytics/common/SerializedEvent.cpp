@@ -0,0 +1,129 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../include/SerializedEvent.h"
+#include "../include/SdkStats.h"
+#include <atomic>
+#include <chrono>
+#include <random>
+
+using namespace sensorsdata;
+
+/**
+ * 生成事件 ID 使用的随机种子，每个进程不同
+ */
+static uint64_t eventIdSeed() {
+    std::random_device device;
+    uint64_t seed = (static_cast<uint64_t>(device()) << 32) ^ device();
+    return seed ^ static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+}
+
+static std::atomic<uint64_t> sEventIdCounter(0);
+
+uint64_t SerializedEvent::generateEventId() {
+    static const uint64_t seed = eventIdSeed();
+    // splitmix64，计数器不重复，因此进程内生成的 ID 不重复
+    uint64_t value = seed + (sEventIdCounter.fetch_add(1, std::memory_order_relaxed) + 1) * 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+std::shared_ptr<const SerializedEvent> SerializedEvent::create(const char *eventName, const EventKey &eventKey,
+                                                               const ObjectNode &properties) {
+    return create(eventName, eventKey, properties, generateEventId());
+}
+
+std::shared_ptr<const SerializedEvent> SerializedEvent::create(const char *eventName, const EventKey &eventKey,
+                                                               const ObjectNode &properties, uint64_t eventId) {
+    std::shared_ptr<SerializedEvent> event(new SerializedEvent());
+    event->name = eventName ? eventName : "";
+    event->key = eventKey;
+    event->id = eventId;
+    {
+        StatsTimer serializeTimer(kStatsPhaseSerialize);
+        string &json = event->buffer;
+        json.reserve(properties.payloadSize());
+        event->spans.reserve(properties.propertiesMap.size());
+        json += '{';
+        for (std::map<PropertyName, ObjectNode::ValueNode>::const_iterator iterator = properties.propertiesMap.begin(); iterator != properties.propertiesMap.end(); ++iterator) {
+            if (!event->spans.empty()) {
+                json += ',';
+            }
+            PropertySpan span;
+            span.begin = static_cast<uint32_t>(json.length());
+            // 与 ObjectNode::toJson 的格式保持一致，驻留的属性名直接拼接预先转义的 JSON 形式
+            iterator->first.appendJson(&json);
+            span.keyLength = static_cast<uint32_t>(json.length() - span.begin - 2);
+            json += ':';
+            json += iterator->second.json();
+            span.end = static_cast<uint32_t>(json.length());
+            event->spans.push_back(span);
+        }
+        json += '}';
+    }
+    StatsRecorder::recordBytesSerialized(event->buffer.length());
+    return event;
+}
+
+bool SerializedEvent::spanHasName(const PropertySpan &span, const string &propertyName) const {
+    return span.keyLength == propertyName.length() &&
+           buffer.compare(span.begin + 1, span.keyLength, propertyName) == 0;
+}
+
+bool SerializedEvent::hasProperty(const string &propertyName) const {
+    for (std::vector<PropertySpan>::const_iterator iterator = spans.begin(); iterator != spans.end(); ++iterator) {
+        if (spanHasName(*iterator, propertyName)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SerializedEvent::writeJson(const std::set<string> *excludedProperties, string *output) const {
+    if (!output) return;
+    if (!excludedProperties || excludedProperties->empty()) {
+        *output += buffer;
+        return;
+    }
+    *output += '{';
+    bool first = true;
+    for (std::vector<PropertySpan>::const_iterator iterator = spans.begin(); iterator != spans.end(); ++iterator) {
+        // 去掉的属性通常只有几个，逐个比较避免为属性名分配内存
+        bool excluded = false;
+        for (std::set<string>::const_iterator name = excludedProperties->begin(); name != excludedProperties->end(); ++name) {
+            if (spanHasName(*iterator, *name)) {
+                excluded = true;
+                break;
+            }
+        }
+        if (excluded) continue;
+        if (first) {
+            first = false;
+        } else {
+            *output += ',';
+        }
+        output->append(buffer, iterator->begin, iterator->end - iterator->begin);
+    }
+    *output += '}';
+}
+
+string EventView::toJson() const {
+    string json;
+    writeJson(&json);
+    return json;
+}
@@ -0,0 +1,281 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "../include/WorkScheduler.h"
+#include "../include/EventFanout.h"
+#include "../include/ProfileCoalescer.h"
+#include "PlatformBridge.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <stdlib.h>
+
+#if defined(__APPLE__)
+#include <pthread.h>
+#include <pthread/qos.h>
+#elif defined(__ANDROID__) || defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace sensorsdata;
+
+namespace {
+    // 缩减后的最小预算，保证每帧仍有进展
+    const uint32_t kMinBudgetMicros = 100;
+    // 独立线程的 nice 值
+    const int kWorkerNice = 10;
+
+    std::atomic<uint32_t> sBaseBudgetMicros(2000);
+    std::atomic<uint32_t> sTargetFrameMicros(16667);
+    std::atomic<uint32_t> sCurrentBudgetMicros(2000);
+
+    std::atomic<uint64_t> sExecutedSteps(0);
+    std::atomic<uint64_t> sDeferredTicks(0);
+    std::atomic<uint64_t> sBackoffTicks(0);
+
+    // 保护 sTasks
+    std::mutex sTasksMutex;
+    std::deque<WorkScheduler::Step> sTasks;
+    // 保证同一时刻只有一个线程执行任务
+    std::mutex sTickMutex;
+
+    std::atomic<bool> sDirectorAttached(false);
+    // 保护独立线程的启动与停止
+    std::mutex sWorkerMutex;
+    std::condition_variable sWorkerCondition;
+    std::thread sWorker;
+    bool sWorkerRunning = false;
+    std::once_flag sWorkerExitHookFlag;
+
+    uint64_t nowMicros() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /**
+     * 帧间隔过长时缩减预算，否则逐步恢复到设置的预算
+     */
+    void adjustBudget(float frameDeltaSeconds) {
+        uint32_t base = sBaseBudgetMicros.load(std::memory_order_relaxed);
+        uint32_t target = sTargetFrameMicros.load(std::memory_order_relaxed);
+        uint32_t current = sCurrentBudgetMicros.load(std::memory_order_relaxed);
+        uint64_t deltaMicros = frameDeltaSeconds > 0 ? static_cast<uint64_t>(frameDeltaSeconds * 1000000) : 0;
+        if (target != 0 && deltaMicros * 4 > static_cast<uint64_t>(target) * 5) {
+            current = current / 2 > kMinBudgetMicros ? current / 2 : kMinBudgetMicros;
+            sBackoffTicks.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            uint32_t step = base / 4 > 0 ? base / 4 : 1;
+            current = current + step < base ? current + step : base;
+        }
+        sCurrentBudgetMicros.store(current, std::memory_order_relaxed);
+    }
+
+    /**
+     * 在预算内执行任务
+     * @param frameDeltaSeconds 距离上一帧的时间
+     * @param adaptive 是否按帧间隔调整预算，独立线程的间隔与渲染帧无关，不参与调整
+     */
+    void runTick(float frameDeltaSeconds, bool adaptive);
+
+    /**
+     * 取出队首任务，没有任务时返回 false
+     */
+    bool popTask(WorkScheduler::Step *step) {
+        std::lock_guard<std::mutex> lock(sTasksMutex);
+        if (sTasks.empty()) {
+            return false;
+        }
+        *step = sTasks.front();
+        sTasks.pop_front();
+        return true;
+    }
+
+    void setWorkerPriority() {
+#if defined(__APPLE__)
+        pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+#elif defined(__ANDROID__) || defined(__linux__)
+        setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), kWorkerNice);
+#endif
+    }
+
+    void workerLoop(uint32_t intervalMillis) {
+        setWorkerPriority();
+        uint64_t last = nowMicros();
+        std::unique_lock<std::mutex> lock(sWorkerMutex);
+        while (sWorkerRunning) {
+            sWorkerCondition.wait_for(lock, std::chrono::milliseconds(intervalMillis));
+            if (!sWorkerRunning) {
+                break;
+            }
+            lock.unlock();
+            uint64_t now = nowMicros();
+            runTick(static_cast<float>(now - last) / 1000000, false);
+            last = now;
+            lock.lock();
+        }
+    }
+
+    /**
+     * 停止独立线程并等待其退出，返回是否有线程被停止
+     */
+    bool joinWorker() {
+        std::thread worker;
+        {
+            std::lock_guard<std::mutex> lock(sWorkerMutex);
+            if (!sWorkerRunning) return false;
+            sWorkerRunning = false;
+            worker = std::move(sWorker);
+        }
+        sWorkerCondition.notify_all();
+        if (worker.joinable()) {
+            worker.join();
+        }
+        return true;
+    }
+
+    /**
+     * 进程退出时停止独立线程，避免 joinable 的 std::thread 析构时调用 terminate。
+     * 此时不再执行剩余任务，原生 SDK 可能已不可用
+     */
+    void joinWorkerAtExit() {
+        joinWorker();
+    }
+
+    void runTick(float frameDeltaSeconds, bool adaptive) {
+        std::unique_lock<std::mutex> tickLock(sTickMutex, std::try_to_lock);
+        if (!tickLock.owns_lock()) {
+            return;
+        }
+        uint64_t budget;
+        if (adaptive) {
+            adjustBudget(frameDeltaSeconds);
+            budget = sCurrentBudgetMicros.load(std::memory_order_relaxed);
+        } else {
+            budget = sBaseBudgetMicros.load(std::memory_order_relaxed);
+        }
+        uint64_t start = nowMicros();
+        ProfileCoalescer::flushIfDue();
+        EventFanout::pump();
+
+        WorkScheduler::Step step;
+        while (nowMicros() - start < budget && popTask(&step)) {
+            bool done = false;
+            do {
+                done = step();
+                sExecutedSteps.fetch_add(1, std::memory_order_relaxed);
+            } while (!done && nowMicros() - start < budget);
+            if (!done) {
+                // 预算用完，剩余步骤留到下一帧，保持任务顺序
+                std::lock_guard<std::mutex> lock(sTasksMutex);
+                sTasks.push_front(step);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(sTasksMutex);
+        if (!sTasks.empty()) {
+            sDeferredTicks.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void WorkScheduler::setFrameBudget(uint32_t budgetMicros, uint32_t targetFrameMicros) {
+    sBaseBudgetMicros.store(budgetMicros, std::memory_order_relaxed);
+    sTargetFrameMicros.store(targetFrameMicros, std::memory_order_relaxed);
+    sCurrentBudgetMicros.store(budgetMicros, std::memory_order_relaxed);
+}
+
+void WorkScheduler::attachToDirector() {
+    if (sDirectorAttached.exchange(true)) return;
+    platform::attachFrameTick();
+}
+
+void WorkScheduler::detachFromDirector() {
+    if (!sDirectorAttached.exchange(false)) return;
+    platform::detachFrameTick();
+    if (!isRunning()) {
+        runAll();
+    }
+}
+
+void WorkScheduler::startWorkerThread(uint32_t intervalMillis) {
+    std::call_once(sWorkerExitHookFlag, []() {
+        atexit(joinWorkerAtExit);
+    });
+    std::lock_guard<std::mutex> lock(sWorkerMutex);
+    if (sWorkerRunning) return;
+    sWorkerRunning = true;
+    sWorker = std::thread(workerLoop, intervalMillis > 0 ? intervalMillis : 1);
+}
+
+void WorkScheduler::stopWorkerThread() {
+    if (!joinWorker()) return;
+    if (!isRunning()) {
+        runAll();
+    }
+}
+
+bool WorkScheduler::isRunning() {
+    if (sDirectorAttached.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(sWorkerMutex);
+    return sWorkerRunning;
+}
+
+void WorkScheduler::post(const Step &step) {
+    if (!step) return;
+    if (!isRunning()) {
+        while (!step()) {
+        }
+        return;
+    }
+    std::lock_guard<std::mutex> lock(sTasksMutex);
+    sTasks.push_back(step);
+}
+
+void WorkScheduler::tick(float frameDeltaSeconds) {
+    runTick(frameDeltaSeconds, true);
+}
+
+void WorkScheduler::runAll() {
+    std::lock_guard<std::mutex> tickLock(sTickMutex);
+    Step step;
+    while (popTask(&step)) {
+        bool done = false;
+        do {
+            done = step();
+            sExecutedSteps.fetch_add(1, std::memory_order_relaxed);
+        } while (!done);
+    }
+}
+
+SchedulerStats WorkScheduler::getStats() {
+    SchedulerStats stats;
+    stats.executedSteps = sExecutedSteps.load(std::memory_order_relaxed);
+    stats.deferredTicks = sDeferredTicks.load(std::memory_order_relaxed);
+    stats.backoffTicks = sBackoffTicks.load(std::memory_order_relaxed);
+    stats.currentBudgetMicros = sCurrentBudgetMicros.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(sTasksMutex);
+    stats.pendingTasks = sTasks.size();
+    return stats;
+}
@@ -0,0 +1,116 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COCOS2DX_SENSORS_DEDUP_INDEX_H_
+#define COCOS2DX_SENSORS_DEDUP_INDEX_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace sensorsdata {
+    /**
+     * 去重索引配置，内存占用由 capacity 与 falsePositiveRate 决定，运行期间固定不变
+     */
+    struct DedupIndexConfig {
+        // 每一代记录的事件 ID 数，索引保留最近两代，即最近 capacity 到 2 * capacity 个已确认的事件
+        size_t capacity;
+        // 每一代写满时的误判率，误判会导致一个未确认的事件被当作重复事件跳过
+        double falsePositiveRate;
+
+        DedupIndexConfig() : capacity(10000), falsePositiveRate(0.0001) {}
+
+        DedupIndexConfig(size_t capacity, double falsePositiveRate)
+                : capacity(capacity), falsePositiveRate(falsePositiveRate) {}
+    };
+
+    /**
+     * 记录最近已确认的事件 ID，使用两代滚动的布隆过滤器。
+     * 当前代写满后清空上一代并与之交换，查询时同时检查两代，不需要扫描事件队列。
+     * 非线程安全，由调用方加锁。
+     */
+    class DedupIndex {
+    public:
+        explicit DedupIndex(const DedupIndexConfig &config = DedupIndexConfig());
+
+        /**
+         * 记录已确认的事件 ID
+         * @param eventId 事件 ID
+         */
+        void add(uint64_t eventId);
+
+        /**
+         * 事件 ID 是否可能已确认，返回 false 时一定未确认
+         * @param eventId 事件 ID
+         * @return 是否可能已确认
+         */
+        bool mightContain(uint64_t eventId) const;
+
+        /**
+         * 清空索引
+         */
+        void clear();
+
+        /**
+         * 获取位数组占用的内存
+         * @return 字节数
+         */
+        size_t memoryBytes() const;
+
+        /**
+         * 按当前记录的 ID 数估算的误判率
+         * @return 误判率
+         */
+        double expectedFalsePositiveRate() const;
+
+        /**
+         * 导出索引，用于在进程重启后恢复，导出的数据只能在相同配置的设备上恢复
+         * @param output 输出
+         */
+        void save(std::string *output) const;
+
+        /**
+         * 从 save 导出的数据恢复索引
+         * @param data 导出的数据
+         * @return 配置不一致或数据损坏时返回 false，索引保持不变
+         */
+        bool restore(const std::string &data);
+
+        const DedupIndexConfig &config() const { return indexConfig; }
+
+    private:
+        struct Generation {
+            std::vector<uint64_t> bits;
+            size_t count;
+
+            Generation() : count(0) {}
+        };
+
+        static bool testBits(const Generation &generation, uint64_t hash1, uint64_t hash2, size_t bitCount,
+                             size_t hashCount);
+
+        DedupIndexConfig indexConfig;
+        // 每一代的位数与哈希函数个数
+        size_t bitCount;
+        size_t hashCount;
+        Generation current;
+        Generation previous;
+    };
+}
+
+#endif // COCOS2DX_SENSORS_DEDUP_INDEX_H_
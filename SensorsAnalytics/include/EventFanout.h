@@ -0,0 +1,196 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COCOS2DX_SENSORS_EVENT_FANOUT_H_
+#define COCOS2DX_SENSORS_EVENT_FANOUT_H_
+
+#include <stdint.h>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "SerializedEvent.h"
+#include "DedupIndex.h"
+
+using namespace std;
+
+namespace sensorsdata {
+    /**
+     * 一批事件的发送结果，acked 为 true 表示服务端已确认，为 false 时这批事件保留在队列中，退避后重试。
+     * 每批事件只能调用一次，可以在任意线程调用
+     */
+    typedef std::function<void(bool acked)> DestinationCompletion;
+
+    /**
+     * 发送一批事件，应将网络请求交给其它线程并立即返回，请求结束后调用 completion。
+     * 同一目的地在 completion 被调用之前不会发送下一批。
+     * 重试的事件 ID 不变，上报时应携带 EventView::eventId() 作为幂等键，以便服务端丢弃确认丢失后重发的事件
+     * @param destination 目的地名称
+     * @param events 事件
+     * @param completion 发送结果回调
+     */
+    typedef std::function<void(const string &destination, const std::vector<EventView> &events,
+                               const DestinationCompletion &completion)> DestinationSender;
+
+    /**
+     * 目的地配置
+     */
+    struct DestinationConfig {
+        // 目的地名称，例如项目名
+        string name;
+        // 允许发送的事件名，为空时发送所有事件
+        std::set<string> eventAllowlist;
+        // 发送前去掉的属性
+        std::set<string> strippedProperties;
+        // 每批发送的事件数
+        size_t batchSize;
+        // 队列容量，超出时丢弃最早的事件，0 表示不限制
+        size_t capacity;
+        // 发送事件的回调
+        DestinationSender sender;
+        // 发送失败后第一次重试的等待时间，单位为毫秒，之后每次失败加倍
+        uint32_t retryInitialMillis;
+        // 重试等待时间的上限，单位为毫秒
+        uint32_t retryMaxMillis;
+        // 已确认事件 ID 的去重索引配置
+        DedupIndexConfig dedup;
+
+        DestinationConfig() : batchSize(50), capacity(1000), retryInitialMillis(1000), retryMaxMillis(60 * 1000) {}
+    };
+
+    /**
+     * 目的地统计
+     */
+    struct DestinationStats {
+        // 等待发送的事件数
+        size_t pendingEvents;
+        // 已确认的事件数
+        uint64_t ackedEvents;
+        // 发送失败的批次数
+        uint64_t failedBatches;
+        // replay 时因已确认而跳过的事件数
+        uint64_t skippedReplays;
+        // 去重索引占用的内存
+        size_t dedupMemoryBytes;
+        // 去重索引当前的估算误判率
+        double dedupFalsePositiveRate;
+
+        DestinationStats() : pendingEvents(0), ackedEvents(0), failedBatches(0), skippedReplays(0),
+                             dedupMemoryBytes(0), dedupFalsePositiveRate(0) {}
+    };
+
+    /**
+     * 将事件分发到原生 SDK 以外的多个目的地，例如同时上报到多个项目。
+     * 事件只序列化一次，各目的地的队列只引用共享的 SerializedEvent，事件名过滤在入队时进行，
+     * 属性过滤在发送时以 EventView 的形式进行，不会复制事件。
+     * WorkScheduler 启动时 track 只负责入队，由 tick 与 flush 发送；未启动时 track 在积累满一批后同步调用 sender。
+     * 队列只保存在内存中，SDK 不持久化事件，进程退出后需要重新发送的事件由 App 自行保存并通过 replay 重新分发。
+     * 事件 ID 只用于这里的目的地，不会传给原生 SDK。
+     */
+    class EventFanout {
+    public:
+        /**
+         * 添加目的地，已存在同名目的地时替换其配置并保留队列中的事件
+         * @param config 目的地配置
+         * @return 配置是否有效
+         */
+        static bool addDestination(const DestinationConfig &config);
+
+        /**
+         * 移除目的地，队列中未发送的事件被丢弃
+         * @param name 目的地名称
+         */
+        static void removeDestination(const string &name);
+
+        /**
+         * 是否存在目的地
+         * @return 是否存在
+         */
+        static bool hasDestinations();
+
+        /**
+         * 将事件加入允许该事件的目的地的队列，不查询去重索引。WorkScheduler 未启动时同步发送积累满的批次
+         * @param event 序列化后的事件
+         */
+        static void dispatch(const std::shared_ptr<const SerializedEvent> &event);
+
+        /**
+         * 重新分发 App 保存的事件，event 需通过 SerializedEvent::create 以原来的事件 ID 创建。
+         * 事件 ID 可能已被某个目的地确认时，不再加入该目的地的队列。
+         * 去重索引存在 DedupIndexConfig::falsePositiveRate 的误判，被误判的事件不会发送到该目的地
+         * @param event 序列化后的事件
+         */
+        static void replay(const std::shared_ptr<const SerializedEvent> &event);
+
+        /**
+         * 发送积累满 batchSize 的队列，以及 flush 之后尚未发送完的队列，处于重试退避中的目的地跳过。
+         * 由 WorkScheduler 的 tick 调用
+         */
+        static void pump();
+
+        /**
+         * 发送所有目的地队列中的事件，包括不足一批的事件。sender 异步完成时在此之后的 pump 中继续发送
+         */
+        static void flush();
+
+        /**
+         * 丢弃所有目的地队列中的事件，保留目的地配置与去重索引，用于 deleteAll
+         */
+        static void clear();
+
+        /**
+         * 确认事件已被服务端接收，用于 completion(false) 之后才收到的确认。
+         * 这些事件从队列中移除并记录到去重索引，不会再次发送
+         * @param name 目的地名称
+         * @param eventIds 事件 ID
+         */
+        static void acknowledge(const string &name, const std::vector<uint64_t> &eventIds);
+
+        /**
+         * 导出目的地的去重索引，用于在进程重启后恢复
+         * @param name 目的地名称
+         * @param output 输出
+         * @return 目的地是否存在
+         */
+        static bool saveDedupIndex(const string &name, string *output);
+
+        /**
+         * 恢复目的地的去重索引
+         * @param name 目的地名称
+         * @param data saveDedupIndex 导出的数据
+         * @return 是否恢复成功
+         */
+        static bool restoreDedupIndex(const string &name, const string &data);
+
+        /**
+         * 获取目的地统计
+         * @param name 目的地名称
+         * @return 统计数据
+         */
+        static DestinationStats getStats(const string &name);
+
+        /**
+         * 获取目的地队列中等待发送的事件数
+         * @param name 目的地名称
+         * @return 事件数
+         */
+        static size_t pendingCount(const string &name);
+    };
+}
+
+#endif // COCOS2DX_SENSORS_EVENT_FANOUT_H_
@@ -0,0 +1,149 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef COCOS2DX_SENSORS_EVENT_LANES_H_
+#define COCOS2DX_SENSORS_EVENT_LANES_H_
+
+#include <stdint.h>
+#include <memory>
+#include "ObjectNode.h"
+#include "SerializedEvent.h"
+
+namespace sensorsdata {
+    /**
+     * 事件优先级，每个优先级对应一个独立的队列
+     */
+    enum EventPriority {
+        // 关键事件，例如支付，立即发送并触发 flush
+        kEventPriorityCritical = 0,
+        // 普通事件，立即发送，与原有 track 行为一致
+        kEventPriorityNormal,
+        // 批量事件，例如高频的游戏内埋点，积累到一定数量后才发送
+        kEventPriorityBulk,
+        kEventPriorityCount,
+    };
+
+    /**
+     * 队列已满时的丢弃策略
+     */
+    enum LaneDropPolicy {
+        // 丢弃队列中最早的事件
+        kLaneDropOldest = 0,
+        // 丢弃新加入的事件
+        kLaneDropNewest,
+    };
+
+    /**
+     * 队列配置
+     */
+    struct LaneConfig {
+        // 队列容量，0 表示不限制
+        size_t capacity;
+        // 队列中的事件数达到该值时发送给原生 SDK，小于等于 1 时立即发送
+        size_t flushThreshold;
+        // 队列已满时的丢弃策略
+        LaneDropPolicy dropPolicy;
+        // 发送给原生 SDK 后是否立即调用原生 SDK 的 flush
+        bool flushAfterDeliver;
+
+        LaneConfig() : capacity(0), flushThreshold(1), dropPolicy(kLaneDropOldest), flushAfterDeliver(false) {}
+
+        LaneConfig(size_t capacity, size_t flushThreshold, LaneDropPolicy dropPolicy, bool flushAfterDeliver)
+                : capacity(capacity), flushThreshold(flushThreshold), dropPolicy(dropPolicy),
+                  flushAfterDeliver(flushAfterDeliver) {}
+    };
+
+    /**
+     * 按优先级划分的事件队列。批量事件在 C++ 层积累，不会进入原生 SDK 的队列，
+     * 因此关键事件不会排在大量批量事件之后，批量事件也不会挤占关键事件的容量。
+     * 入队的事件记录 track 时的时间作为 $time；identify/login/logout 前会发送队列中的事件，
+     * 保证事件归属于 track 时的用户。队列只保存在内存中，进程被杀死时未发送的事件会丢失，
+     * 需要时可在进入后台时调用 SensorsAnalytics::flush。
+     */
+    class EventLanes {
+    public:
+        /**
+         * 设置队列配置
+         * @param priority 优先级
+         * @param config 队列配置
+         */
+        static void setLaneConfig(EventPriority priority, const LaneConfig &config);
+
+        /**
+         * 获取队列配置
+         * @param priority 优先级
+         * @return 队列配置
+         */
+        static LaneConfig getLaneConfig(EventPriority priority);
+
+        /**
+         * 将事件加入对应的队列，达到发送阈值时发送给原生 SDK
+         * @param eventName 事件名
+         * @param properties 事件属性
+         * @param priority 优先级
+         */
+        static void enqueue(const char *eventName, const ObjectNode &properties, EventPriority priority);
+
+        /**
+         * 将事件加入对应的队列，发送时使用缓存的平台字符串
+         * @param eventKey 驻留的事件名
+         * @param properties 事件属性
+         * @param priority 优先级
+         */
+        static void enqueue(const EventKey &eventKey, const ObjectNode &properties, EventPriority priority);
+
+        /**
+         * 将已序列化的事件加入对应的队列，队列只引用该事件，不复制事件属性
+         * @param event 序列化后的事件
+         * @param priority 优先级
+         */
+        static void enqueue(const std::shared_ptr<const SerializedEvent> &event, EventPriority priority);
+
+        /**
+         * 将队列中的事件全部发送给原生 SDK
+         * @param priority 优先级
+         */
+        static void drain(EventPriority priority);
+
+        /**
+         * 按优先级从高到低发送所有队列中的事件
+         */
+        static void drainAll();
+
+        /**
+         * 丢弃所有队列中的事件，包括 WorkScheduler 尚未发送的批次
+         */
+        static void clear();
+
+        /**
+         * 获取队列中等待发送的事件数
+         * @param priority 优先级
+         * @return 事件数
+         */
+        static size_t pendingCount(EventPriority priority);
+
+        /**
+         * 获取队列因容量限制丢弃的事件数
+         * @param priority 优先级
+         * @return 事件数
+         */
+        static uint64_t droppedCount(EventPriority priority);
+    };
+}
+
+#endif // COCOS2DX_SENSORS_EVENT_LANES_H_
@@ -0,0 +1,71 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef COCOS2DX_SENSORS_IDENTITY_CACHE_H_
+#define COCOS2DX_SENSORS_IDENTITY_CACHE_H_
+
+#include <memory>
+#include <string>
+
+using namespace std;
+
+namespace sensorsdata {
+    /**
+     * 用户标识快照，发布后不再修改
+     */
+    struct IdentitySnapshot {
+        string distinctId;
+        string loginId;
+        string anonymousId;
+    };
+
+    /**
+     * 缓存原生 SDK 的用户标识，避免每次读取都跨越 JNI/ObjC。
+     * 启动后从原生 SDK 加载一次，identify/login/logout 后重新从原生 SDK 读取，
+     * 以原生 SDK 校验、规范化后的值为准。
+     * 快照以 shared_ptr 发布，读取方持有的快照在用户标识变化后仍然有效，最后一个持有者释放时回收。
+     */
+    class IdentityCache {
+    public:
+        /**
+         * 是否已从原生 SDK 加载
+         * @return 是否已加载
+         */
+        static bool isLoaded();
+
+        /**
+         * 获取当前快照，未加载时返回空快照
+         * @return 当前快照，不会为空
+         */
+        static std::shared_ptr<const IdentitySnapshot> current();
+
+        /**
+         * 使用原生 SDK 中的用户标识初始化，仅第一次调用生效
+         * @param snapshot 原生 SDK 中的用户标识
+         */
+        static void load(const IdentitySnapshot &snapshot);
+
+        /**
+         * 使用 identify/login/logout 后从原生 SDK 重新读取的用户标识更新，与当前快照相同时不发布新快照
+         * @param snapshot 原生 SDK 中的用户标识
+         */
+        static void update(const IdentitySnapshot &snapshot);
+    };
+}
+
+#endif // COCOS2DX_SENSORS_IDENTITY_CACHE_H_
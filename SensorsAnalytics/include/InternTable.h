@@ -0,0 +1,146 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef COCOS2DX_SENSORS_INTERN_TABLE_H_
+#define COCOS2DX_SENSORS_INTERN_TABLE_H_
+
+#include <stdint.h>
+#include <string>
+
+using namespace std;
+
+namespace sensorsdata {
+    /**
+     * 全局字符串驻留表，为重复使用的事件名与属性名分配紧凑的 ID。
+     * 条目发布后不会修改或释放，按 ID 读取为无锁操作。
+     * 仅用于固定的事件名与属性名，不要驻留动态生成的字符串。
+     */
+    class InternTable {
+    public:
+        // 无效 ID
+        static const uint32_t kInvalidId = 0;
+
+        /**
+         * 驻留字符串，相同的字符串返回相同的 ID
+         * @param value 字符串
+         * @return ID，value 为 NULL 或驻留表已满时返回 kInvalidId
+         */
+        static uint32_t intern(const char *value);
+
+        /**
+         * 获取驻留的字符串
+         * @param id ID
+         * @return 字符串，ID 无效时返回空字符串
+         */
+        static const string &name(uint32_t id);
+
+        /**
+         * 获取驻留时生成的 JSON 形式，即转义并加上引号的字符串
+         * @param id ID
+         * @return JSON 形式，ID 无效时返回空字符串
+         */
+        static const string &json(uint32_t id);
+
+        /**
+         * 获取平台字符串缓存，Android 为 jstring 全局引用，iOS 为 NSString
+         * @param id ID
+         * @return 平台字符串，未设置时返回 NULL
+         */
+        static void *platformString(uint32_t id);
+
+        /**
+         * 设置平台字符串缓存，只有第一次设置生效
+         * @param id ID
+         * @param value 平台字符串
+         * @return 是否设置成功，失败时调用方需释放 value
+         */
+        static bool setPlatformString(uint32_t id, void *value);
+    };
+
+    /**
+     * 驻留的事件名
+     */
+    class EventKey {
+    public:
+        EventKey() : id(InternTable::kInvalidId) {}
+
+        explicit EventKey(const char *eventName) : id(InternTable::intern(eventName)) {}
+
+        bool isValid() const { return id != InternTable::kInvalidId; }
+
+        const string &name() const { return InternTable::name(id); }
+
+        uint32_t id;
+    };
+
+    /**
+     * 驻留的属性名
+     */
+    class PropertyKey {
+    public:
+        PropertyKey() : id(InternTable::kInvalidId) {}
+
+        explicit PropertyKey(const char *propertyName) : id(InternTable::intern(propertyName)) {}
+
+        bool isValid() const { return id != InternTable::kInvalidId; }
+
+        const string &name() const { return InternTable::name(id); }
+
+        uint32_t id;
+    };
+
+    /**
+     * ObjectNode 的属性名，由 PropertyKey 创建时只保存 ID，复制时不分配内存；
+     * 由字符串创建时保存字符串
+     */
+    class PropertyName {
+    public:
+        PropertyName(const char *propertyName) : value(propertyName) {}
+
+        PropertyName(const string &propertyName) : value(propertyName) {}
+
+        explicit PropertyName(const PropertyKey &propertyKey) : key(propertyKey) {}
+
+        const string &name() const { return key.isValid() ? key.name() : value; }
+
+        operator const string &() const { return name(); }
+
+        bool operator<(const PropertyName &other) const {
+            if (key.isValid() && key.id == other.key.id) return false;
+            return name() < other.name();
+        }
+
+        /**
+         * 获取转义并加上引号后的字节数
+         * @return 字节数
+         */
+        size_t jsonSize() const;
+
+        /**
+         * 追加转义并加上引号的属性名，驻留的属性名直接拼接驻留时生成的 JSON 形式
+         * @param buffer 输出
+         */
+        void appendJson(string *buffer) const;
+
+    private:
+        PropertyKey key;
+        string value;
+    };
+}
+
+#endif // COCOS2DX_SENSORS_INTERN_TABLE_H_
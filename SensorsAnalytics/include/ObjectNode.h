@@ -19,15 +19,19 @@
 #define COCOS2DX_SENSORS_OBJECT_NODE_H_
 
 #include <stdio.h>
+#include <string.h>
 #include <string>
 #include <map>
 #include <vector>
+#include "InternTable.h"
 
 using namespace std;
 
 namespace sensorsdata {
     class ObjectNode {
     public:
+        ObjectNode() : entriesBytes(0) {}
+
         void setNumber(const char *propertyName, int32_t value);
 
         void setNumber(const char *propertyName, int64_t value);
@@ -49,19 +53,55 @@ namespace sensorsdata {
          */
         void setDateTime(const char *propertyName, const char *value);
 
+        /**
+         * 使用驻留的属性名设置属性，属性已存在时不会为属性名分配内存
+         */
+        void setNumber(const PropertyKey &propertyKey, int32_t value);
+
+        void setNumber(const PropertyKey &propertyKey, int64_t value);
+
+        void setNumber(const PropertyKey &propertyKey, double value);
+
+        void setString(const PropertyKey &propertyKey, const char *value);
+
+        void setBool(const PropertyKey &propertyKey, bool value);
+
+        void setList(const PropertyKey &propertyKey, const std::vector<string> &value);
+
+        void setDateTime(const PropertyKey &propertyKey, time_t seconds, int milliseconds);
+
         void clear();
 
         static string toJson(const ObjectNode &node);
 
+        /**
+         * 预热序列化使用的 ostringstream、locale 与时区信息，避免首次 toJson 时初始化
+         */
+        static void warmUp();
+
         void mergeFrom(const ObjectNode &anotherNode);
 
+        /**
+         * 获取序列化后的字节数，在 setX 时增量计算，复杂度为 O(1)
+         * 直接修改 propertiesMap 不会更新该值
+         * @return 序列化后的字节数
+         */
+        size_t payloadSize() const;
+
         class ValueNode;
 
-        std::map<string, ValueNode> propertiesMap;
+        std::map<PropertyName, ValueNode> propertiesMap;
 
     private:
         static void dumpNode(const ObjectNode &node, string *buffer);
 
+        void putValue(const PropertyName &propertyName, const ValueNode &value);
+
+        void recomputeEntriesBytes();
+
+        // 所有 "key":value 片段的字节数之和，不含 '{'、'}' 与分隔符 ','
+        size_t entriesBytes;
+
         enum ValueNodeType {
             NUMBER,
             INT,
@@ -93,9 +133,34 @@ namespace sensorsdata {
 
         static void toStr(const ValueNode &node, string *buffer);
 
-    private:
+        /**
+         * 获取序列化后的字节数
+         * @return 序列化后的字节数
+         */
+        size_t jsonSize() const { return jsonFragment.length(); }
+
+        /**
+         * 获取构造时缓存的序列化片段
+         * @return 序列化片段
+         */
+        const string &json() const { return jsonFragment; }
+
+        /**
+         * 获取字符串转义并加上引号后的字节数
+         * @param value 字符串
+         * @return 字节数
+         */
+        static size_t stringJsonSize(const string &value);
+
+        /**
+         * 转义字符串并加上引号后追加到 buffer
+         * @param value 字符串
+         * @param buffer 输出
+         */
         static void dumpString(const string &value, string *buffer);
 
+    private:
+
         static void dumpList(const std::vector<string> &value, string *buffer);
 
         static void dumpDateTime(const time_t &seconds, int milliseconds, string *buffer);
@@ -106,21 +171,8 @@ namespace sensorsdata {
 
         ValueNodeType nodeType;
 
-        union UnionValue {
-            double numberValue;
-            bool boolValue;
-            struct {
-                time_t seconds;
-                int milliseconds;
-            } datetimeValue;
-            int64_t intValue;
-
-            UnionValue() { memset(this, 0, sizeof(UnionValue)); }
-        } valueData;
-
-        string stringData;
-        std::vector<string> listData;
-        ObjectNode objectData;
+        // 构造时生成的序列化片段，不再保留原始值，toJson 时直接拼接
+        string jsonFragment;
     };
 }
 
@@ -0,0 +1,116 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COCOS2DX_SENSORS_PAYLOAD_BUDGET_H_
+#define COCOS2DX_SENSORS_PAYLOAD_BUDGET_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace sensorsdata {
+    class ObjectNode;
+
+    /**
+     * 属性体积预算，单位为字节，取值为 0 时表示不限制
+     */
+    struct PayloadBudget {
+        // 单个字符串属性（含 List 中的元素）的最大字节数，超出时截断
+        size_t maxStringBytes;
+        // 单个 List 属性的最大元素个数，超出时截断
+        size_t maxListItems;
+        // 单个 List 属性序列化后的最大字节数，超出时截断
+        size_t maxListBytes;
+        // 单个事件属性序列化后的最大字节数，超出时丢弃该事件
+        size_t maxEventBytes;
+
+        PayloadBudget() : maxStringBytes(8192),
+                          maxListItems(500),
+                          maxListBytes(64 * 1024),
+                          maxEventBytes(1024 * 1024) {}
+    };
+
+    /**
+     * 超出预算的统计
+     */
+    struct PayloadStats {
+        // 被截断的字符串个数
+        uint64_t truncatedStrings;
+        // 被截断的 List 个数
+        uint64_t truncatedLists;
+        // 因超出单个事件预算而被丢弃的事件个数
+        uint64_t rejectedEvents;
+
+        PayloadStats() : truncatedStrings(0), truncatedLists(0), rejectedEvents(0) {}
+    };
+
+    /**
+     * 在跨越 JNI/ObjC 之前校验属性体积，避免超大属性被完整序列化并复制到原生 SDK。
+     * 字符串与 List 在 ObjectNode::setX 时截断，事件在 track 时根据 ObjectNode 记录的体积丢弃，
+     * 校验开销为 O(1)。
+     */
+    class PayloadGuard {
+    public:
+        /**
+         * 设置属性体积预算，建议在初始化时调用
+         * @param budget 属性体积预算
+         */
+        static void setBudget(const PayloadBudget &budget);
+
+        /**
+         * 获取当前属性体积预算
+         * @return 属性体积预算
+         */
+        static PayloadBudget getBudget();
+
+        /**
+         * 获取超出预算的统计
+         * @return 统计数据
+         */
+        static PayloadStats getStats();
+
+        /**
+         * 清空超出预算的统计
+         */
+        static void resetStats();
+
+        /**
+         * 按预算截断字符串，不会截断 UTF-8 多字节字符
+         * @param value 字符串
+         * @return 是否发生截断
+         */
+        static bool truncateString(string *value);
+
+        /**
+         * 按预算截断 List 的元素个数、元素长度与总字节数
+         * @param value List
+         * @return 是否发生截断
+         */
+        static bool truncateList(std::vector<string> *value);
+
+        /**
+         * 判断事件属性是否在预算之内，超出时记录丢弃次数
+         * @param properties 事件属性
+         * @return 是否允许发送
+         */
+        static bool acceptEvent(const ObjectNode &properties);
+    };
+}
+
+#endif // COCOS2DX_SENSORS_PAYLOAD_BUDGET_H_
@@ -0,0 +1,94 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef COCOS2DX_SENSORS_PROFILE_COALESCER_H_
+#define COCOS2DX_SENSORS_PROFILE_COALESCER_H_
+
+#include <stdint.h>
+#include "ObjectNode.h"
+
+namespace sensorsdata {
+    /**
+     * 合并时间窗口内的 profileSet、profileSetOnce 与 itemSet，窗口结束或 flush 时每类只发送一条记录。
+     * profileSet 与 itemSet 按属性后写入的值生效，profileSetOnce 按属性先写入的值生效，itemSet 按 item 分别合并。
+     * 发送时先发送 profileSet 再发送 profileSetOnce，与逐条发送的结果一致。
+     * 窗口结束时由内部的定时线程发送，合并后的记录超过 PayloadBudget::maxEventBytes 时提前发送。
+     * 默认关闭。
+     */
+    class ProfileCoalescer {
+    public:
+        /**
+         * 设置合并的时间窗口
+         * @param windowMillis 时间窗口，单位为毫秒，0 表示关闭合并，关闭时会先发送已合并的数据
+         */
+        static void setWindow(uint32_t windowMillis);
+
+        /**
+         * 是否开启合并
+         * @return 是否开启
+         */
+        static bool isEnabled();
+
+        /**
+         * 合并用户属性，未开启合并时返回 false，由调用方直接发送
+         * @param properties 用户属性
+         * @return 是否已合并
+         */
+        static bool profileSet(const ObjectNode &properties);
+
+        /**
+         * 合并首次设置的用户属性，未开启合并时返回 false
+         * @param properties 用户属性
+         * @return 是否已合并
+         */
+        static bool profileSetOnce(const ObjectNode &properties);
+
+        /**
+         * 合并 item 属性，未开启合并时返回 false
+         * @param itemType item 类型
+         * @param itemId item ID
+         * @param properties item 属性
+         * @return 是否已合并
+         */
+        static bool itemSet(const char *itemType, const char *itemId, const ObjectNode &properties);
+
+        /**
+         * 丢弃某个 item 尚未发送的属性，在 itemDelete 时调用
+         * @param itemType item 类型
+         * @param itemId item ID
+         */
+        static void discardItem(const char *itemType, const char *itemId);
+
+        /**
+         * 时间窗口结束时发送合并的数据，定时线程之外 WorkScheduler 的 tick 也会调用
+         */
+        static void flushIfDue();
+
+        /**
+         * 立即发送合并的数据
+         */
+        static void flush();
+
+        /**
+         * 丢弃当前窗口中未发送的数据，用于 deleteAll
+         */
+        static void clear();
+    };
+}
+
+#endif // COCOS2DX_SENSORS_PROFILE_COALESCER_H_
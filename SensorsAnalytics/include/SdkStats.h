@@ -0,0 +1,158 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef COCOS2DX_SENSORS_SDK_STATS_H_
+#define COCOS2DX_SENSORS_SDK_STATS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace sensorsdata {
+    /**
+     * 统计的接口
+     */
+    enum StatsApi {
+        kStatsApiTrack = 0,
+        kStatsApiTrackTimerEnd,
+        kStatsApiLogin,
+        kStatsApiProfileSet,
+        kStatsApiProfileSetOnce,
+        kStatsApiRegisterSuperProperties,
+        kStatsApiTrackAppInstall,
+        kStatsApiItemSet,
+        kStatsApiCount,
+    };
+
+    /**
+     * 接口耗时的阶段
+     */
+    enum StatsPhase {
+        // ObjectNode::toJson
+        kStatsPhaseSerialize = 0,
+        // JSON 转换为 JSONObject/NSDictionary
+        kStatsPhaseBridge,
+        // 调用原生 SDK 接口
+        kStatsPhaseNative,
+        kStatsPhaseCount,
+    };
+
+    // 耗时直方图的桶个数，第 i 个桶统计 [2^(i-1), 2^i) 微秒，最后一个桶包含更大的值
+    const int kStatsHistogramBuckets = 16;
+
+    /**
+     * 耗时直方图，单位为微秒
+     */
+    struct LatencyHistogram {
+        uint64_t buckets[kStatsHistogramBuckets];
+        uint64_t count;
+        uint64_t totalMicros;
+        uint64_t maxMicros;
+    };
+
+    /**
+     * 单个接口的统计
+     */
+    struct ApiStats {
+        uint64_t calls;
+        LatencyHistogram phases[kStatsPhaseCount];
+    };
+
+    /**
+     * SDK 自身开销的统计
+     */
+    struct SdkStats {
+        ApiStats apis[kStatsApiCount];
+        // 序列化的总字节数
+        uint64_t bytesSerialized;
+        // 丢弃的事件数，包含超出属性体积预算的事件
+        uint64_t droppedEvents;
+        // 等待发送到原生 SDK 的事件数
+        uint64_t queueDepth;
+    };
+
+    /**
+     * 记录 SDK 自身开销。计数器按线程存储，只由所属线程写入，读取时合并，
+     * 关闭时每个统计点只有一次 relaxed 原子读取的开销。默认关闭。
+     */
+    class StatsRecorder {
+    public:
+        static void setEnabled(bool enabled);
+
+        static bool isEnabled();
+
+        static void recordCall(StatsApi api);
+
+        static void recordLatency(StatsApi api, StatsPhase phase, uint64_t micros);
+
+        static void recordBytesSerialized(size_t bytes);
+
+        static void recordDroppedEvent();
+
+        /**
+         * 更新队列深度
+         * @param delta 变化量，入队为正数，出队为负数
+         */
+        static void addQueueDepth(int64_t delta);
+
+        /**
+         * 合并所有线程的计数器
+         * @return 统计数据
+         */
+        static SdkStats snapshot();
+
+        static void reset();
+    };
+
+    /**
+     * 在作用域内统计一次接口调用，作用域内的 StatsTimer 计入该接口
+     */
+    class StatsScope {
+    public:
+        explicit StatsScope(StatsApi api);
+
+        ~StatsScope();
+
+    private:
+        StatsScope(const StatsScope &);
+
+        StatsScope &operator=(const StatsScope &);
+
+        int previousApi;
+    };
+
+    /**
+     * 统计作用域内某个阶段的耗时，计入当前 StatsScope 的接口
+     */
+    class StatsTimer {
+    public:
+        explicit StatsTimer(StatsPhase phase);
+
+        ~StatsTimer();
+
+    private:
+        StatsTimer(const StatsTimer &);
+
+        StatsTimer &operator=(const StatsTimer &);
+
+        StatsPhase phase;
+        int api;
+        uint64_t startMicros;
+    };
+}
+
+#endif // COCOS2DX_SENSORS_SDK_STATS_H_
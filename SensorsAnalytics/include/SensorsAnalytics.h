@@ -20,6 +20,12 @@
 
 #include "ObjectNode.h"
 #include "FlushPolicy.h"
+#include "PayloadBudget.h"
+#include "SdkStats.h"
+#include "EventLanes.h"
+#include "EventFanout.h"
+#include "ProfileCoalescer.h"
+#include "WorkScheduler.h"
 
 #define SENSORS_ANALYTICS_PLUGIN_VERSION_KEY "$lib_plugin_version"
 #define SENSORS_ANALYTICS_PLUGIN_VERSION_VALUE "cocos2dx:0.0.1"
@@ -28,7 +34,13 @@ namespace sensorsdata {
     class SensorsAnalytics {
 
     public:
-        
+
+        /**
+         * 预热 SDK：获取 SDK 实例、查找原生方法、加载用户标识并预热序列化，
+         * 避免首次调用 track 等接口时在主线程上初始化。可在后台线程调用，需在原生 SDK 初始化之后调用
+         */
+        static void warmUp();
+
         /**
          * 自定义匿名 ID
          * @param anonymousId 匿名 ID
@@ -48,6 +60,29 @@ namespace sensorsdata {
          */
         static void track(const char* eventName, const ObjectNode &properties);
 
+        /**
+         * 按优先级追踪一个带有属性的事件
+         * @param eventName 事件名
+         * @param properties 事件属性
+         * @param priority 优先级，关键事件立即发送并触发 flush，批量事件积累到一定数量后才发送
+         */
+        static void track(const char* eventName, const ObjectNode &properties, EventPriority priority);
+
+        /**
+         * 使用驻留的事件名追踪事件，重复追踪同名事件时不再创建 jstring/NSString
+         * @param eventKey 驻留的事件名，例如 static const EventKey kPurchase("Purchase");
+         * @param properties 事件属性
+         */
+        static void track(const EventKey &eventKey, const ObjectNode &properties);
+
+        /**
+         * 使用驻留的事件名按优先级追踪事件
+         * @param eventKey 驻留的事件名
+         * @param properties 事件属性
+         * @param priority 优先级
+         */
+        static void track(const EventKey &eventKey, const ObjectNode &properties, EventPriority priority);
+
         /**
          * 设置当前用户的登录 ID
          * @param loginId 登录 ID
@@ -59,6 +94,24 @@ namespace sensorsdata {
          */
         static void logout();
 
+        /**
+         * 获取当前的 distinct ID，首次调用时从原生 SDK 加载，之后读取 C++ 层的缓存
+         * @return distinct ID
+         */
+        static string getDistinctId();
+
+        /**
+         * 获取当前的登录 ID，未登录时为空字符串
+         * @return 登录 ID
+         */
+        static string getLoginId();
+
+        /**
+         * 获取当前的匿名 ID
+         * @return 匿名 ID
+         */
+        static string getAnonymousId();
+
         /**
          * 设置用户属性
          * @param properties 用户属性
@@ -72,7 +125,7 @@ namespace sensorsdata {
         static string getSuperProperties();
 
         /**
-         * 强制上传数据
+         * 将各优先级队列中的事件发送给原生 SDK，发送各目的地队列中的事件，并强制上传数据
          */
         static void flush();
 
@@ -179,6 +232,19 @@ namespace sensorsdata {
          * @param itemId item ID
          */
         static void itemDelete(const char *itemType, const char *itemId);
+
+        /**
+         * 开启或关闭 SDK 自身开销的统计，默认关闭
+         * @param enabled 是否开启
+         */
+        static void enableStats(bool enabled);
+
+        /**
+         * 获取 SDK 自身开销的统计，包括各接口的调用次数、序列化/桥接/原生 SDK 耗时直方图、
+         * 序列化字节数、丢弃的事件数与队列深度
+         * @return 统计数据
+         */
+        static SdkStats getStats();
     };
 }
 
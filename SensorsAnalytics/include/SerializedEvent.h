@@ -0,0 +1,155 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COCOS2DX_SENSORS_SERIALIZED_EVENT_H_
+#define COCOS2DX_SENSORS_SERIALIZED_EVENT_H_
+
+#include <stdint.h>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "ObjectNode.h"
+
+using namespace std;
+
+namespace sensorsdata {
+    /**
+     * 只序列化一次的事件，创建后不可修改，通过 shared_ptr 在原生 SDK 队列与各个目的地之间共享
+     */
+    class SerializedEvent {
+    public:
+        /**
+         * 序列化事件属性
+         * @param eventName 事件名
+         * @param eventKey 驻留的事件名，未驻留时无效
+         * @param properties 事件属性
+         * @return 序列化后的事件
+         */
+        static std::shared_ptr<const SerializedEvent> create(const char *eventName, const EventKey &eventKey,
+                                                             const ObjectNode &properties);
+
+        /**
+         * 使用指定的事件 ID 序列化事件属性，用于通过 EventFanout::replay 重新发送 App 保存的事件
+         * @param eventName 事件名
+         * @param eventKey 驻留的事件名，未驻留时无效
+         * @param properties 事件属性
+         * @param eventId 事件 ID
+         * @return 序列化后的事件
+         */
+        static std::shared_ptr<const SerializedEvent> create(const char *eventName, const EventKey &eventKey,
+                                                             const ObjectNode &properties, uint64_t eventId);
+
+        /**
+         * 生成事件 ID，进程内不重复，不同进程之间以随机种子区分
+         * @return 事件 ID
+         */
+        static uint64_t generateEventId();
+
+        const string &eventName() const { return name; }
+
+        const EventKey &eventKey() const { return key; }
+
+        /**
+         * 获取 track 时生成的事件 ID，重试发送时保持不变，可作为上报的幂等键
+         * @return 事件 ID
+         */
+        uint64_t eventId() const { return id; }
+
+        /**
+         * 获取序列化后的事件属性
+         * @return 事件属性的 JSON
+         */
+        const string &json() const { return buffer; }
+
+        size_t propertyCount() const { return spans.size(); }
+
+        /**
+         * 是否包含某个属性
+         * @param propertyName 属性名
+         * @return 是否包含
+         */
+        bool hasProperty(const string &propertyName) const;
+
+        /**
+         * 去掉部分属性后追加到 output，直接拼接已序列化的片段
+         * @param excludedProperties 去掉的属性，为 NULL 或空时追加完整的 JSON
+         * @param output 输出
+         */
+        void writeJson(const std::set<string> *excludedProperties, string *output) const;
+
+    private:
+        SerializedEvent() : id(0) {}
+
+        SerializedEvent(const SerializedEvent &);
+
+        SerializedEvent &operator=(const SerializedEvent &);
+
+        /**
+         * 单个属性 "key":value 在 buffer 中的位置
+         */
+        struct PropertySpan {
+            uint32_t begin;
+            uint32_t end;
+            uint32_t keyLength;
+        };
+
+        bool spanHasName(const PropertySpan &span, const string &propertyName) const;
+
+        string name;
+        EventKey key;
+        uint64_t id;
+        string buffer;
+        std::vector<PropertySpan> spans;
+    };
+
+    /**
+     * 某个目的地看到的事件，引用共享的 SerializedEvent，属性过滤在输出时才进行
+     */
+    class EventView {
+    public:
+        EventView() {}
+
+        EventView(const std::shared_ptr<const SerializedEvent> &event,
+                  const std::shared_ptr<const std::set<string> > &strippedProperties)
+                : source(event), strippedProperties(strippedProperties) {}
+
+        const SerializedEvent &event() const { return *source; }
+
+        const string &eventName() const { return source->eventName(); }
+
+        uint64_t eventId() const { return source->eventId(); }
+
+        /**
+         * 将过滤后的事件属性追加到 output
+         * @param output 输出
+         */
+        void writeJson(string *output) const { source->writeJson(strippedProperties.get(), output); }
+
+        /**
+         * 获取过滤后的事件属性，未过滤任何属性时与 SerializedEvent::json() 相同
+         * @return 事件属性的 JSON
+         */
+        string toJson() const;
+
+    private:
+        std::shared_ptr<const SerializedEvent> source;
+        std::shared_ptr<const std::set<string> > strippedProperties;
+    };
+}
+
+#endif // COCOS2DX_SENSORS_SERIALIZED_EVENT_H_
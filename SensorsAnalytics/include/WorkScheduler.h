@@ -0,0 +1,115 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef COCOS2DX_SENSORS_WORK_SCHEDULER_H_
+#define COCOS2DX_SENSORS_WORK_SCHEDULER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+
+namespace sensorsdata {
+    /**
+     * 调度器统计
+     */
+    struct SchedulerStats {
+        // 已执行的步骤数
+        uint64_t executedSteps;
+        // 预算用完时仍有剩余任务的 tick 次数
+        uint64_t deferredTicks;
+        // 因帧耗时过高而缩减预算的 tick 次数
+        uint64_t backoffTicks;
+        // 等待执行的任务数
+        size_t pendingTasks;
+        // 当前每帧预算，单位为微秒
+        uint32_t currentBudgetMicros;
+    };
+
+    /**
+     * 按帧预算协作执行 SDK 的后台工作，例如批量事件的序列化与发送。
+     * 任务被拆分为可恢复的小步骤，每次 tick 在预算内执行尽可能多的步骤，帧耗时过高时自动缩减预算。
+     * 可以由 cocos 的 Director 驱动，也可以由独立线程驱动。未启动时 SDK 同步执行这些工作。
+     */
+    class WorkScheduler {
+    public:
+        /**
+         * 任务的一个步骤，返回 true 表示任务已完成，返回 false 表示还有剩余步骤
+         */
+        typedef std::function<bool()> Step;
+
+        /**
+         * 设置每帧预算
+         * @param budgetMicros 每帧预算，单位为微秒
+         * @param targetFrameMicros 目标帧间隔，帧间隔超过该值的 1.25 倍时缩减预算
+         */
+        static void setFrameBudget(uint32_t budgetMicros, uint32_t targetFrameMicros);
+
+        /**
+         * 在 cocos 的 Director 中每帧调用 tick，需在 cocos 主线程调用
+         */
+        static void attachToDirector();
+
+        /**
+         * 停止在 cocos 的 Director 中调用 tick
+         */
+        static void detachFromDirector();
+
+        /**
+         * 启动独立线程执行任务，线程以较低优先级运行，每次使用设置的预算，不按帧间隔缩减。
+         * 进程退出时线程自动停止，剩余任务不再执行
+         * @param intervalMillis 执行的间隔，单位为毫秒
+         */
+        static void startWorkerThread(uint32_t intervalMillis);
+
+        /**
+         * 停止独立线程，未执行的任务在调用方线程中执行完毕
+         */
+        static void stopWorkerThread();
+
+        /**
+         * 是否已由 Director 或独立线程驱动
+         * @return 是否已启动
+         */
+        static bool isRunning();
+
+        /**
+         * 添加任务，未启动时立即同步执行完毕
+         * @param step 任务的步骤
+         */
+        static void post(const Step &step);
+
+        /**
+         * 在预算内执行任务，帧间隔过长时缩减预算，供渲染循环调用
+         * @param frameDeltaSeconds 距离上一帧的时间，单位为秒
+         */
+        static void tick(float frameDeltaSeconds);
+
+        /**
+         * 不考虑预算，在调用方线程中执行完所有任务
+         */
+        static void runAll();
+
+        /**
+         * 获取调度器统计
+         * @return 统计数据
+         */
+        static SchedulerStats getStats();
+    };
+}
+
+#endif // COCOS2DX_SENSORS_WORK_SCHEDULER_H_
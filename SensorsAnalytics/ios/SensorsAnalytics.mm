@@ -20,6 +20,9 @@
 #endif
 
 #include "SensorsAnalytics.h"
+#include "IdentityCache.h"
+#include "../common/PlatformBridge.h"
+#include "cocos2d.h"
 #if __has_include(<SensorsAnalyticsSDK/SensorsAnalyticsSDK.h>)
 #import <SensorsAnalyticsSDK/SensorsAnalyticsSDK.h>
 #else
@@ -32,12 +35,26 @@ static NSString *NSStringFromCString(const char* cstr){
     return cstr ? [NSString stringWithUTF8String:cstr] : nil;
 }
 
+/// 获取驻留事件名对应的 NSString, 首次调用时创建并由驻留表持有
+static NSString *NSStringFromEventKey(const EventKey &eventKey) {
+    void *cached = InternTable::platformString(eventKey.id);
+    if (cached) return (__bridge NSString *)cached;
+    NSString *string = NSStringFromCString(eventKey.name().c_str());
+    void *retained = (void *)CFBridgingRetain(string);
+    if (!InternTable::setPlatformString(eventKey.id, retained)) {
+        // 其它线程已经创建
+        CFRelease(retained);
+        return (__bridge NSString *)InternTable::platformString(eventKey.id);
+    }
+    return string;
+}
+
 static char *CStringFromNSString(NSString *string) {
     return (char *)[string UTF8String];
 }
 
-static NSDictionary *NSDictionaryFromObjectNode(const ObjectNode &node) {
-    string json = ObjectNode::toJson(node);
+static NSDictionary *NSDictionaryFromJSON(const string &json) {
+    StatsTimer bridgeTimer(kStatsPhaseBridge);
     NSString *string = NSStringFromCString(json.c_str());
     NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding];
     
@@ -45,6 +62,16 @@ static NSDictionary *NSDictionaryFromObjectNode(const ObjectNode &node) {
     return [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:nil];
 }
 
+static NSDictionary *NSDictionaryFromObjectNode(const ObjectNode &node) {
+    string json;
+    {
+        StatsTimer serializeTimer(kStatsPhaseSerialize);
+        json = ObjectNode::toJson(node);
+    }
+    StatsRecorder::recordBytesSerialized(json.length());
+    return NSDictionaryFromJSON(json);
+}
+
 static char *CStringFromNSDictionary(NSDictionary *dic) {
     
     if (!dic) return nil;
@@ -55,23 +82,96 @@ static char *CStringFromNSDictionary(NSDictionary *dic) {
     return (char *)[jsonStr UTF8String];
 }
 
+/// $lib_plugin_version 属性名, 只创建一次
+static NSString *LibPluginVersionKey() {
+    static NSString *key;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        key = NSStringFromCString(SENSORS_ANALYTICS_PLUGIN_VERSION_KEY);
+    });
+    return key;
+}
+
+/// $lib_plugin_version 属性值, 只创建一次
+static NSArray *LibPluginVersionValue() {
+    static NSArray *value;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        value = @[NSStringFromCString(SENSORS_ANALYTICS_PLUGIN_VERSION_VALUE)];
+    });
+    return value;
+}
+
 /// 通过插件触发的事件, 添加 $lib_plugin_version 属性
 /// 1. 在应用程序生命周期中, 第一次通过插件 track 事件时, 需要添加 $lib_plugin_version 属性, 后续事件无需添加该属性
 /// 2. 当用户的属性中包含 $lib_plugin_version 时, 插件不进行覆盖
 /// @param properties 事件属性
 static NSDictionary *PropertiesByAddingLibPluginVersionFromProperties(NSDictionary *properties) {
-    if (properties[NSStringFromCString(SENSORS_ANALYTICS_PLUGIN_VERSION_KEY)]) return properties;
+    if (properties[LibPluginVersionKey()]) return properties;
     __block NSMutableDictionary *result;
     static dispatch_once_t onceToken;
     dispatch_once(&onceToken, ^{
         result = [NSMutableDictionary dictionaryWithDictionary:properties];
-        result[NSStringFromCString(SENSORS_ANALYTICS_PLUGIN_VERSION_KEY)] = @[NSStringFromCString(SENSORS_ANALYTICS_PLUGIN_VERSION_VALUE)];
+        result[LibPluginVersionKey()] = LibPluginVersionValue();
     });
     return result ? [result copy] : properties;
 }
 
+/// 从 SDK 读取用户标识
+static IdentitySnapshot ReadIdentity(SensorsAnalyticsSDK *sdk) {
+    IdentitySnapshot snapshot;
+    snapshot.distinctId = sdk.distinctId.UTF8String ?: "";
+    snapshot.loginId = sdk.loginId.UTF8String ?: "";
+    snapshot.anonymousId = sdk.anonymousId.UTF8String ?: "";
+    return snapshot;
+}
+
+/// 从 SDK 加载用户标识, 仅在 SDK 已初始化时加载一次
+static std::shared_ptr<const IdentitySnapshot> LoadIdentity() {
+    SensorsAnalyticsSDK *sdk = SensorsAnalyticsSDK.sharedInstance;
+    if (!IdentityCache::isLoaded() && sdk) {
+        IdentityCache::load(ReadIdentity(sdk));
+    }
+    return IdentityCache::current();
+}
+
+/// identify/login/logout 后重新从 SDK 读取用户标识, SDK 可能拒绝或规范化传入的 ID
+static void ReloadIdentity() {
+    SensorsAnalyticsSDK *sdk = SensorsAnalyticsSDK.sharedInstance;
+    if (sdk) {
+        IdentityCache::update(ReadIdentity(sdk));
+    }
+}
+
+bool platform::warmUp() {
+    SensorsAnalyticsSDK *sdk = SensorsAnalyticsSDK.sharedInstance;
+    if (!sdk) return false;
+    LibPluginVersionKey();
+    LibPluginVersionValue();
+    LoadIdentity();
+    // 预热 NSJSONSerialization
+    ObjectNode node;
+    node.setString("warm_up", "");
+    NSDictionaryFromObjectNode(node);
+    return true;
+}
+
+/// 发送队列中的事件, 在会影响事件内容的设置变化前调用, 使事件按 track 时的状态发送
+static void DrainQueuedEvents() {
+    WorkScheduler::runAll();
+    EventLanes::drainAll();
+}
+
+/// 用户标识变化前发送队列中的事件与已合并的用户属性, 避免归属到其它用户
+static void FlushBeforeIdentityChange() {
+    DrainQueuedEvents();
+    ProfileCoalescer::flush();
+}
+
 void SensorsAnalytics::identify(const char *anonymousId) {
+    FlushBeforeIdentityChange();
     [SensorsAnalyticsSDK.sharedInstance identify:NSStringFromCString(anonymousId)];
+    ReloadIdentity();
 }
 
 void SensorsAnalytics::track(const char *eventName) {
@@ -79,23 +179,70 @@ void SensorsAnalytics::track(const char *eventName) {
     SensorsAnalytics::track(eventName, properties);
 }
 
-void SensorsAnalytics::track(const char *eventName, const ObjectNode &properties) {
-    NSDictionary *dic = NSDictionaryFromObjectNode(properties);
-    [SensorsAnalyticsSDK.sharedInstance track:NSStringFromCString(eventName)
+/// 将事件时间以 NSDate 写入 $time 属性, 原生 SDK 以该属性作为事件时间, 保留用户设置的 $time
+static NSDictionary *PropertiesByAddingEventTime(NSDictionary *properties, int64_t eventTimeMillis) {
+    if (eventTimeMillis <= 0 || properties[@"$time"]) return properties;
+    NSMutableDictionary *result = properties ? [NSMutableDictionary dictionaryWithDictionary:properties]
+                                             : [NSMutableDictionary dictionary];
+    result[@"$time"] = [NSDate dateWithTimeIntervalSince1970:eventTimeMillis / 1000.0];
+    return [result copy];
+}
+
+void platform::track(const char *eventName, const ObjectNode &properties, const EventKey &eventKey,
+                     int64_t eventTimeMillis) {
+    StatsScope statsScope(kStatsApiTrack);
+    NSString *name = eventKey.isValid() ? NSStringFromEventKey(eventKey) : NSStringFromCString(eventName);
+    NSDictionary *dic = PropertiesByAddingEventTime(NSDictionaryFromObjectNode(properties), eventTimeMillis);
+    StatsTimer nativeTimer(kStatsPhaseNative);
+    [SensorsAnalyticsSDK.sharedInstance track:name
+                               withProperties:PropertiesByAddingLibPluginVersionFromProperties(dic)];
+}
+
+void platform::track(const SerializedEvent &event, int64_t eventTimeMillis) {
+    StatsScope statsScope(kStatsApiTrack);
+    NSString *name = event.eventKey().isValid() ? NSStringFromEventKey(event.eventKey())
+                                                : NSStringFromCString(event.eventName().c_str());
+    NSDictionary *dic = PropertiesByAddingEventTime(NSDictionaryFromJSON(event.json()), eventTimeMillis);
+    StatsTimer nativeTimer(kStatsPhaseNative);
+    [SensorsAnalyticsSDK.sharedInstance track:name
                                withProperties:PropertiesByAddingLibPluginVersionFromProperties(dic)];
 }
 
 void SensorsAnalytics::login(const char *loginId) {
-    [SensorsAnalyticsSDK.sharedInstance login:NSStringFromCString(loginId)
-                               withProperties:PropertiesByAddingLibPluginVersionFromProperties(nil)];
+    StatsScope statsScope(kStatsApiLogin);
+    FlushBeforeIdentityChange();
+    {
+        StatsTimer nativeTimer(kStatsPhaseNative);
+        [SensorsAnalyticsSDK.sharedInstance login:NSStringFromCString(loginId)
+                                   withProperties:PropertiesByAddingLibPluginVersionFromProperties(nil)];
+    }
+    ReloadIdentity();
 }
 
 void SensorsAnalytics::logout() {
+    FlushBeforeIdentityChange();
     [SensorsAnalyticsSDK.sharedInstance logout];
+    ReloadIdentity();
+}
+
+string SensorsAnalytics::getDistinctId() {
+    return IdentityCache::isLoaded() ? IdentityCache::current()->distinctId : LoadIdentity()->distinctId;
 }
 
-void SensorsAnalytics::profileSet(const ObjectNode &properties) {
-    [SensorsAnalyticsSDK.sharedInstance set:NSDictionaryFromObjectNode(properties)];
+string SensorsAnalytics::getLoginId() {
+    return IdentityCache::isLoaded() ? IdentityCache::current()->loginId : LoadIdentity()->loginId;
+}
+
+string SensorsAnalytics::getAnonymousId() {
+    return IdentityCache::isLoaded() ? IdentityCache::current()->anonymousId : LoadIdentity()->anonymousId;
+}
+
+void platform::profileSet(const ObjectNode &properties) {
+    StatsScope statsScope(kStatsApiProfileSet);
+    if (!PayloadGuard::acceptEvent(properties)) return;
+    NSDictionary *dic = NSDictionaryFromObjectNode(properties);
+    StatsTimer nativeTimer(kStatsPhaseNative);
+    [SensorsAnalyticsSDK.sharedInstance set:dic];
 }
 
 string SensorsAnalytics::getSuperProperties() {
@@ -103,9 +250,32 @@ string SensorsAnalytics::getSuperProperties() {
     return string(CStringFromNSDictionary(properties));
 }
 
-void SensorsAnalytics::flush() {
+void platform::flush() {
     [SensorsAnalyticsSDK.sharedInstance flush];
 }
+
+/// 在 Director 的 Scheduler 中注册的 key 与 target
+static const char *const kFrameTickKey = "sensorsdata_work_scheduler";
+static char sFrameTickTarget;
+
+void platform::attachFrameTick() {
+    cocos2d::Director::getInstance()->getScheduler()->schedule([](float dt) {
+        WorkScheduler::tick(dt);
+    }, &sFrameTickTarget, 0, false, kFrameTickKey);
+}
+
+void platform::detachFrameTick() {
+    cocos2d::Director::getInstance()->getScheduler()->unschedule(kFrameTickKey, &sFrameTickTarget);
+}
+
+void SensorsAnalytics::flush() {
+    // 先发送 WorkScheduler 中尚未发送的批次，保证事件顺序
+    WorkScheduler::runAll();
+    EventLanes::drainAll();
+    EventFanout::flush();
+    ProfileCoalescer::flush();
+    platform::flush();
+}
  
 string SensorsAnalytics::trackTimerStart(const char *eventName) {
     NSString *eventId = [SensorsAnalyticsSDK.sharedInstance trackTimerStart:NSStringFromCString(eventName)];
@@ -126,7 +296,10 @@ void SensorsAnalytics::trackTimerEnd(const char *eventName) {
 }
 
 void SensorsAnalytics::trackTimerEnd(const char *eventName, const ObjectNode &properties) {
+    StatsScope statsScope(kStatsApiTrackTimerEnd);
+    if (!PayloadGuard::acceptEvent(properties)) return;
     NSDictionary *dic = NSDictionaryFromObjectNode(properties);
+    StatsTimer nativeTimer(kStatsPhaseNative);
     [SensorsAnalyticsSDK.sharedInstance trackTimerEnd:NSStringFromCString(eventName)
                                        withProperties:PropertiesByAddingLibPluginVersionFromProperties(dic)];
 }
@@ -136,14 +309,21 @@ void SensorsAnalytics::clearTrackTimer() {
 }
 
 void SensorsAnalytics::registerSuperProperties(const ObjectNode &properties) {
-    [SensorsAnalyticsSDK.sharedInstance registerSuperProperties:NSDictionaryFromObjectNode(properties)];
+    StatsScope statsScope(kStatsApiRegisterSuperProperties);
+    if (!PayloadGuard::acceptEvent(properties)) return;
+    DrainQueuedEvents();
+    NSDictionary *dic = NSDictionaryFromObjectNode(properties);
+    StatsTimer nativeTimer(kStatsPhaseNative);
+    [SensorsAnalyticsSDK.sharedInstance registerSuperProperties:dic];
 }
 
 void SensorsAnalytics::unregisterSuperProperty(const char *superPropertyName) {
+    DrainQueuedEvents();
     [SensorsAnalyticsSDK.sharedInstance unregisterSuperProperty:NSStringFromCString(superPropertyName)];
 }
 
 void SensorsAnalytics::clearSuperProperties() {
+    DrainQueuedEvents();
     [SensorsAnalyticsSDK.sharedInstance clearSuperProperties];
 }
 
@@ -157,8 +337,12 @@ void SensorsAnalytics::setFlushNetworkPolicy(FlushNetworkPolicy types) {
     [SensorsAnalyticsSDK.sharedInstance setFlushNetworkPolicy:result];
 }
 
-void SensorsAnalytics::profileSetOnce(const ObjectNode &properties) {
-    [SensorsAnalyticsSDK.sharedInstance setOnce:NSDictionaryFromObjectNode(properties)];
+void platform::profileSetOnce(const ObjectNode &properties) {
+    StatsScope statsScope(kStatsApiProfileSetOnce);
+    if (!PayloadGuard::acceptEvent(properties)) return;
+    NSDictionary *dic = NSDictionaryFromObjectNode(properties);
+    StatsTimer nativeTimer(kStatsPhaseNative);
+    [SensorsAnalyticsSDK.sharedInstance setOnce:dic];
 }
 
 void SensorsAnalytics::removeTimer(const char *eventName) {
@@ -166,26 +350,43 @@ void SensorsAnalytics::removeTimer(const char *eventName) {
 }
 
 void SensorsAnalytics::trackAppInstall(const ObjectNode &properties, bool disableCallback) {
+    StatsScope statsScope(kStatsApiTrackAppInstall);
+    if (!PayloadGuard::acceptEvent(properties)) return;
+    NSDictionary *dic = NSDictionaryFromObjectNode(properties);
+    StatsTimer nativeTimer(kStatsPhaseNative);
     [SensorsAnalyticsSDK.sharedInstance trackInstallation:@"$AppInstall"
-                                           withProperties:NSDictionaryFromObjectNode(properties)
+                                           withProperties:dic
                                           disableCallback:disableCallback];
+    // 激活事件与关键事件一样立即上传
+    platform::flush();
 }
 
 void SensorsAnalytics::trackAppInstall() {
     [SensorsAnalyticsSDK.sharedInstance trackInstallation:@"$AppInstall"];
+    platform::flush();
 }
 
 void SensorsAnalytics::deleteAll() {
+    // 丢弃 C++ 层尚未发送的数据, 避免在 deleteAll 之后继续上报
+    EventLanes::clear();
+    ProfileCoalescer::clear();
+    EventFanout::clear();
     [SensorsAnalyticsSDK.sharedInstance deleteAll];
 }
 
-void SensorsAnalytics::itemSet(const char *itemType, const char *itemId, const ObjectNode &properties) {
+void platform::itemSet(const char *itemType, const char *itemId, const ObjectNode &properties) {
+    StatsScope statsScope(kStatsApiItemSet);
+    if (!PayloadGuard::acceptEvent(properties)) return;
+    NSDictionary *dic = NSDictionaryFromObjectNode(properties);
+    StatsTimer nativeTimer(kStatsPhaseNative);
     [SensorsAnalyticsSDK.sharedInstance itemSetWithType:NSStringFromCString(itemType)
                                                  itemId:NSStringFromCString(itemId)
-                                             properties:NSDictionaryFromObjectNode(properties)];
+                                             properties:dic];
 }
 
 void SensorsAnalytics::itemDelete(const char *itemType, const char *itemId) {
+    // 删除后不再发送该 item 尚未发送的属性
+    ProfileCoalescer::discardItem(itemType, itemId);
     [SensorsAnalyticsSDK.sharedInstance itemDeleteWithType:NSStringFromCString(itemType)
                                                     itemId:NSStringFromCString(itemId)];
 }
@@ -0,0 +1,186 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * 去重索引的基准测试：
+ * 1. 不同 capacity 与 falsePositiveRate 下的内存占用、实测误判率与 add/mightContain 的耗时；
+ * 2. 模拟丢弃部分确认的服务端，统计重试产生的重复事件，以及进程重启后 replay 时跳过的已确认事件与被误判跳过的未发送事件。
+ *
+ * 用法：dedup_benchmark
+ */
+
+#include "platform_stub.h"
+#include "../include/SensorsAnalytics.h"
+#include <chrono>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace sensorsdata;
+
+// 测量误判率时查询的未记录 ID 数
+static const size_t kProbeCount = 1000000;
+
+static double elapsedNanos(std::chrono::steady_clock::time_point start, size_t operations) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() /
+           static_cast<double>(operations);
+}
+
+static void measureFalsePositiveRate() {
+    const size_t capacities[] = {1000, 10000, 100000};
+    const double rates[] = {0.01, 0.001, 0.0001};
+    printf("%10s %10s %12s %14s %12s %10s %10s\n", "capacity", "target", "memory(B)", "measured", "expected",
+           "add(ns)", "query(ns)");
+    for (size_t i = 0; i < sizeof(capacities) / sizeof(capacities[0]); ++i) {
+        for (size_t j = 0; j < sizeof(rates) / sizeof(rates[0]); ++j) {
+            DedupIndex index(DedupIndexConfig(capacities[i], rates[j]));
+            std::vector<uint64_t> acked(capacities[i]);
+            for (size_t k = 0; k < acked.size(); ++k) {
+                acked[k] = SerializedEvent::generateEventId();
+            }
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (size_t k = 0; k < acked.size(); ++k) {
+                index.add(acked[k]);
+            }
+            double addNanos = elapsedNanos(start, acked.size());
+
+            // 新生成的 ID 一定未被记录，命中即为误判
+            std::vector<uint64_t> probes(kProbeCount);
+            for (size_t k = 0; k < probes.size(); ++k) {
+                probes[k] = SerializedEvent::generateEventId();
+            }
+            size_t falsePositives = 0;
+            start = std::chrono::steady_clock::now();
+            for (size_t k = 0; k < probes.size(); ++k) {
+                if (index.mightContain(probes[k])) {
+                    ++falsePositives;
+                }
+            }
+            double queryNanos = elapsedNanos(start, kProbeCount);
+            printf("%10zu %10g %12zu %14.6f %12.6f %10.1f %10.1f\n", capacities[i], rates[j], index.memoryBytes(),
+                   static_cast<double>(falsePositives) / kProbeCount, index.expectedFalsePositiveRate(), addNanos,
+                   queryNanos);
+        }
+    }
+}
+
+/**
+ * 模拟服务端：记录收到的事件 ID，按 ackDropRate 丢弃确认
+ */
+struct LossyServer {
+    std::mt19937 random;
+    std::bernoulli_distribution dropAck;
+    std::map<uint64_t, int> received;
+    size_t duplicates;
+
+    explicit LossyServer(double ackDropRate) : random(42), dropAck(ackDropRate), duplicates(0) {}
+
+    DestinationSender sender() {
+        return [this](const string &, const std::vector<EventView> &events, const DestinationCompletion &completion) {
+            for (std::vector<EventView>::const_iterator iterator = events.begin(); iterator != events.end(); ++iterator) {
+                if (received[iterator->eventId()]++ > 0) {
+                    ++duplicates;
+                }
+            }
+            completion(!dropAck(random));
+        };
+    }
+};
+
+static void simulateReplay(double ackDropRate) {
+    const char *const name = "lossy";
+    const size_t eventCount = 10000;
+    // 进程退出前尚未分发的事件比例，这些事件只在 replay 时发送
+    const double unsentRate = 0.1;
+
+    LossyServer server(ackDropRate);
+    DestinationConfig config;
+    config.name = name;
+    config.batchSize = 50;
+    config.capacity = 0;
+    config.retryInitialMillis = 0;
+    config.retryMaxMillis = 0;
+    config.dedup = DedupIndexConfig(eventCount, 0.0001);
+    config.sender = server.sender();
+    EventFanout::addDestination(config);
+
+    // App 自行保存的事件
+    std::vector<std::shared_ptr<const SerializedEvent> > stored;
+    std::set<uint64_t> unsent;
+    std::mt19937 random(7);
+    std::bernoulli_distribution isUnsent(unsentRate);
+    ObjectNode properties;
+    properties.setString("scene", "benchmark");
+    for (size_t i = 0; i < eventCount; ++i) {
+        std::shared_ptr<const SerializedEvent> event = SerializedEvent::create("Replay", EventKey(), properties);
+        stored.push_back(event);
+        if (isUnsent(random)) {
+            unsent.insert(event->eventId());
+            continue;
+        }
+        EventFanout::dispatch(event);
+    }
+    // 确认丢失的批次在退避后重试，直到全部确认
+    while (EventFanout::pendingCount(name) > 0) {
+        EventFanout::flush();
+    }
+    size_t retryDuplicates = server.duplicates;
+    std::map<uint64_t, int> receivedBeforeReplay = server.received;
+
+    // 模拟进程重启：App 不知道哪些事件已确认，以原来的 ID 重新分发全部事件
+    for (std::vector<std::shared_ptr<const SerializedEvent> >::const_iterator iterator = stored.begin();
+         iterator != stored.end(); ++iterator) {
+        const SerializedEvent &event = **iterator;
+        EventFanout::replay(SerializedEvent::create(event.eventName().c_str(), event.eventKey(), properties,
+                                                    event.eventId()));
+    }
+    while (EventFanout::pendingCount(name) > 0) {
+        EventFanout::flush();
+    }
+
+    // replay 时再次发送的已确认事件，去重索引的作用是让这个值接近 0
+    size_t replayDuplicates = 0;
+    for (std::map<uint64_t, int>::const_iterator iterator = receivedBeforeReplay.begin();
+         iterator != receivedBeforeReplay.end(); ++iterator) {
+        if (server.received[iterator->first] > iterator->second) {
+            ++replayDuplicates;
+        }
+    }
+    size_t lost = 0;
+    for (std::set<uint64_t>::const_iterator iterator = unsent.begin(); iterator != unsent.end(); ++iterator) {
+        if (server.received.find(*iterator) == server.received.end()) {
+            ++lost;
+        }
+    }
+    DestinationStats stats = EventFanout::getStats(name);
+    printf("ackDrop=%.2f events=%zu retryDuplicates=%zu replaySkipped=%llu replayDuplicates=%zu "
+           "unsentLost=%zu/%zu memory=%zuB\n",
+           ackDropRate, eventCount, retryDuplicates, static_cast<unsigned long long>(stats.skippedReplays),
+           replayDuplicates, lost, unsent.size(), stats.dedupMemoryBytes);
+    EventFanout::removeDestination(name);
+}
+
+int main() {
+    measureFalsePositiveRate();
+    printf("\n");
+    const double ackDropRates[] = {0.0, 0.05, 0.2};
+    for (size_t i = 0; i < sizeof(ackDropRates) / sizeof(ackDropRates[0]); ++i) {
+        simulateReplay(ackDropRates[i]);
+    }
+    return 0;
+}
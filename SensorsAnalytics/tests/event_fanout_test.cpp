@@ -0,0 +1,238 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "platform_stub.h"
+#include "../include/SensorsAnalytics.h"
+#include <chrono>
+#include <thread>
+
+using namespace sensorsdata;
+
+static const char *const kDestination = "mirror";
+
+/**
+ * 记录 sender 收到的批次，completion 由测试决定何时调用，模拟异步的网络请求
+ */
+struct RecordingSender {
+    std::vector<std::vector<EventView> > batches;
+    std::vector<DestinationCompletion> completions;
+
+    DestinationSender sender() {
+        return [this](const string &, const std::vector<EventView> &events, const DestinationCompletion &completion) {
+            batches.push_back(events);
+            completions.push_back(completion);
+        };
+    }
+};
+
+static DestinationConfig makeConfig(RecordingSender *recorder, size_t batchSize) {
+    DestinationConfig config;
+    config.name = kDestination;
+    config.batchSize = batchSize;
+    config.retryInitialMillis = 50;
+    config.retryMaxMillis = 100;
+    config.sender = recorder->sender();
+    return config;
+}
+
+static void trackEvents(int count) {
+    for (int i = 0; i < count; ++i) {
+        ObjectNode properties;
+        properties.setNumber("index", static_cast<int64_t>(i));
+        SensorsAnalytics::track("Fanout", properties);
+    }
+}
+
+static void testTrackDoesNotSendWhileSchedulerRuns() {
+    RecordingSender recorder;
+    EventFanout::addDestination(makeConfig(&recorder, 2));
+    trackEvents(5);
+    // WorkScheduler 启动时 track 只入队，即使已积累满一批
+    CHECK(recorder.batches.empty());
+    CHECK(EventFanout::pendingCount(kDestination) == 5);
+
+    EventFanout::pump();
+    CHECK(recorder.batches.size() == 1);
+    EventFanout::removeDestination(kDestination);
+}
+
+static void testAsyncCompletion() {
+    RecordingSender recorder;
+    EventFanout::addDestination(makeConfig(&recorder, 2));
+    trackEvents(4);
+    EventFanout::pump();
+    // 第一批未完成前不发送第二批
+    EventFanout::pump();
+    CHECK(recorder.batches.size() == 1);
+    CHECK(recorder.batches.size() == 1 && recorder.batches[0].size() == 2);
+
+    // 在其它线程完成
+    DestinationCompletion completion = recorder.completions[0];
+    std::thread([completion]() { completion(true); }).join();
+    // 重复的回调被忽略
+    completion(false);
+    CHECK(EventFanout::pendingCount(kDestination) == 2);
+    CHECK(EventFanout::getStats(kDestination).failedBatches == 0);
+
+    EventFanout::pump();
+    CHECK(recorder.batches.size() == 2);
+    recorder.completions[1](true);
+    CHECK(EventFanout::pendingCount(kDestination) == 0);
+    CHECK(EventFanout::getStats(kDestination).ackedEvents == 4);
+    EventFanout::removeDestination(kDestination);
+}
+
+static void testFlushSendsPartialBatch() {
+    RecordingSender recorder;
+    EventFanout::addDestination(makeConfig(&recorder, 10));
+    trackEvents(3);
+    EventFanout::pump();
+    CHECK(recorder.batches.empty());
+
+    EventFanout::flush();
+    CHECK(recorder.batches.size() == 1 && recorder.batches[0].size() == 3);
+    recorder.completions[0](true);
+    CHECK(EventFanout::pendingCount(kDestination) == 0);
+
+    // 队列清空后恢复按批发送
+    trackEvents(1);
+    EventFanout::pump();
+    CHECK(recorder.batches.size() == 1);
+    EventFanout::removeDestination(kDestination);
+}
+
+static void testRetryBackoff() {
+    RecordingSender recorder;
+    EventFanout::addDestination(makeConfig(&recorder, 1));
+    trackEvents(1);
+    EventFanout::pump();
+    CHECK(recorder.batches.size() == 1);
+    recorder.completions[0](false);
+    CHECK(EventFanout::getStats(kDestination).failedBatches == 1);
+
+    // 退避期间不重试
+    EventFanout::pump();
+    EventFanout::flush();
+    CHECK(recorder.batches.size() == 1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(70));
+    EventFanout::pump();
+    CHECK(recorder.batches.size() == 2);
+    // 重试的事件 ID 不变
+    CHECK(recorder.batches.size() == 2 && recorder.batches[1][0].eventId() == recorder.batches[0][0].eventId());
+    recorder.completions[1](false);
+
+    // 第二次失败后等待时间加倍
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EventFanout::pump();
+    CHECK(recorder.batches.size() == 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EventFanout::pump();
+    CHECK(recorder.batches.size() == 3);
+    recorder.completions[2](true);
+    CHECK(EventFanout::pendingCount(kDestination) == 0);
+
+    // 成功后退避复位
+    trackEvents(1);
+    EventFanout::pump();
+    CHECK(recorder.batches.size() == 4);
+    recorder.completions[3](true);
+    EventFanout::removeDestination(kDestination);
+}
+
+static void testSynchronousSender() {
+    int batches = 0;
+    DestinationConfig config;
+    config.name = kDestination;
+    config.batchSize = 2;
+    config.sender = [&batches](const string &, const std::vector<EventView> &, const DestinationCompletion &completion) {
+        ++batches;
+        completion(true);
+    };
+    EventFanout::addDestination(config);
+    trackEvents(5);
+    // 同步完成时一次 pump 发送所有满批
+    EventFanout::pump();
+    CHECK(batches == 2);
+    EventFanout::flush();
+    CHECK(batches == 3);
+    CHECK(EventFanout::pendingCount(kDestination) == 0);
+    EventFanout::removeDestination(kDestination);
+}
+
+static void testReplaySkipsAckedEvents() {
+    RecordingSender recorder;
+    EventFanout::addDestination(makeConfig(&recorder, 1));
+    ObjectNode properties;
+    std::shared_ptr<const SerializedEvent> acked = SerializedEvent::create("Fanout", EventKey(), properties);
+    std::shared_ptr<const SerializedEvent> unacked = SerializedEvent::create("Fanout", EventKey(), properties);
+    EventFanout::dispatch(acked);
+    EventFanout::pump();
+    recorder.completions[0](true);
+
+    // dispatch 不查询去重索引，即使 ID 已确认也入队
+    EventFanout::dispatch(acked);
+    CHECK(EventFanout::pendingCount(kDestination) == 1);
+    EventFanout::clear();
+
+    // replay 以原来的 ID 重新分发，已确认的事件跳过
+    EventFanout::replay(SerializedEvent::create("Fanout", EventKey(), properties, acked->eventId()));
+    EventFanout::replay(SerializedEvent::create("Fanout", EventKey(), properties, unacked->eventId()));
+    CHECK(EventFanout::pendingCount(kDestination) == 1);
+    CHECK(EventFanout::getStats(kDestination).skippedReplays == 1);
+    EventFanout::removeDestination(kDestination);
+}
+
+static void testSchedulerOffSendsInline() {
+    size_t sent = 0;
+    DestinationConfig config;
+    config.name = kDestination;
+    config.batchSize = 50;
+    config.capacity = 1000;
+    config.sender = [&sent](const string &, const std::vector<EventView> &events,
+                            const DestinationCompletion &completion) {
+        sent += events.size();
+        completion(true);
+    };
+    EventFanout::addDestination(config);
+    CHECK(!WorkScheduler::isRunning());
+    // 超过队列容量的事件在 flush 之前也不会被丢弃
+    trackEvents(1500);
+    CHECK(sent == 1500);
+    CHECK(EventFanout::pendingCount(kDestination) == 0);
+    CHECK(EventFanout::getStats(kDestination).ackedEvents == 1500);
+    EventFanout::removeDestination(kDestination);
+}
+
+int main() {
+    testSchedulerOffSendsInline();
+    // 以下用例在 WorkScheduler 启动时运行，platform_stub 不会调用 tick，由用例手动调用 pump
+    WorkScheduler::attachToDirector();
+    testTrackDoesNotSendWhileSchedulerRuns();
+    testAsyncCompletion();
+    testFlushSendsPartialBatch();
+    testRetryBackoff();
+    testSynchronousSender();
+    testReplaySkipsAckedEvents();
+    WorkScheduler::detachFromDirector();
+    if (platform_stub::failures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", platform_stub::failures);
+        return 1;
+    }
+    printf("event_fanout_test passed\n");
+    return 0;
+}
@@ -0,0 +1,183 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "platform_stub.h"
+#include "../include/SensorsAnalytics.h"
+#include <chrono>
+#include <thread>
+
+using namespace sensorsdata;
+
+static LaneConfig sDefaultConfigs[kEventPriorityCount];
+
+static void reset() {
+    EventLanes::clear();
+    for (int priority = 0; priority < kEventPriorityCount; ++priority) {
+        EventLanes::setLaneConfig(static_cast<EventPriority>(priority), sDefaultConfigs[priority]);
+    }
+    platform_stub::takeCalls();
+    platform_stub::takeEventTimes();
+}
+
+static int64_t nowMillis() {
+    return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+static void trackIndex(const char *eventName, int index, EventPriority priority) {
+    ObjectNode properties;
+    properties.setNumber("index", index);
+    SensorsAnalytics::track(eventName, properties, priority);
+}
+
+static void testNormalSendsDirectly() {
+    reset();
+    trackIndex("normal", 1, kEventPriorityNormal);
+    std::vector<std::string> calls = platform_stub::takeCalls();
+    CHECK(calls.size() == 1 && calls[0] == "track normal {\"index\":1}");
+    CHECK(EventLanes::pendingCount(kEventPriorityNormal) == 0);
+}
+
+static void testCriticalFlushesAfterDeliver() {
+    reset();
+    trackIndex("pay", 1, kEventPriorityCritical);
+    std::vector<std::string> calls = platform_stub::takeCalls();
+    CHECK(calls.size() == 2);
+    CHECK(calls.size() == 2 && calls[0] == "track pay {\"index\":1}");
+    CHECK(calls.size() == 2 && calls[1] == "flush");
+}
+
+static void testBulkThreshold() {
+    reset();
+    EventLanes::setLaneConfig(kEventPriorityBulk, LaneConfig(0, 3, kLaneDropOldest, false));
+    trackIndex("bulk", 1, kEventPriorityBulk);
+    trackIndex("bulk", 2, kEventPriorityBulk);
+    CHECK(platform_stub::callCount() == 0);
+    CHECK(EventLanes::pendingCount(kEventPriorityBulk) == 2);
+
+    trackIndex("bulk", 3, kEventPriorityBulk);
+    std::vector<std::string> calls = platform_stub::takeCalls();
+    CHECK(calls.size() == 3);
+    CHECK(calls.size() == 3 && calls[0] == "track bulk {\"index\":1}");
+    CHECK(calls.size() == 3 && calls[2] == "track bulk {\"index\":3}");
+    CHECK(EventLanes::pendingCount(kEventPriorityBulk) == 0);
+}
+
+static void testDropOldest() {
+    reset();
+    EventLanes::setLaneConfig(kEventPriorityBulk, LaneConfig(2, 10, kLaneDropOldest, false));
+    uint64_t dropped = EventLanes::droppedCount(kEventPriorityBulk);
+    trackIndex("bulk", 1, kEventPriorityBulk);
+    trackIndex("bulk", 2, kEventPriorityBulk);
+    trackIndex("bulk", 3, kEventPriorityBulk);
+    CHECK(EventLanes::pendingCount(kEventPriorityBulk) == 2);
+    CHECK(EventLanes::droppedCount(kEventPriorityBulk) == dropped + 1);
+
+    EventLanes::drain(kEventPriorityBulk);
+    std::vector<std::string> calls = platform_stub::takeCalls();
+    CHECK(calls.size() == 2);
+    CHECK(calls.size() == 2 && calls[0] == "track bulk {\"index\":2}");
+    CHECK(calls.size() == 2 && calls[1] == "track bulk {\"index\":3}");
+}
+
+static void testDropNewest() {
+    reset();
+    EventLanes::setLaneConfig(kEventPriorityBulk, LaneConfig(2, 10, kLaneDropNewest, false));
+    uint64_t dropped = EventLanes::droppedCount(kEventPriorityBulk);
+    trackIndex("bulk", 1, kEventPriorityBulk);
+    trackIndex("bulk", 2, kEventPriorityBulk);
+    trackIndex("bulk", 3, kEventPriorityBulk);
+    CHECK(EventLanes::pendingCount(kEventPriorityBulk) == 2);
+    CHECK(EventLanes::droppedCount(kEventPriorityBulk) == dropped + 1);
+
+    EventLanes::drain(kEventPriorityBulk);
+    std::vector<std::string> calls = platform_stub::takeCalls();
+    CHECK(calls.size() == 2);
+    CHECK(calls.size() == 2 && calls[0] == "track bulk {\"index\":1}");
+    CHECK(calls.size() == 2 && calls[1] == "track bulk {\"index\":2}");
+}
+
+static void testDrainAllByPriority() {
+    reset();
+    EventLanes::setLaneConfig(kEventPriorityCritical, LaneConfig(0, 10, kLaneDropNewest, true));
+    EventLanes::setLaneConfig(kEventPriorityNormal, LaneConfig(0, 10, kLaneDropOldest, false));
+    EventLanes::setLaneConfig(kEventPriorityBulk, LaneConfig(0, 10, kLaneDropOldest, false));
+    trackIndex("bulk", 1, kEventPriorityBulk);
+    trackIndex("normal", 1, kEventPriorityNormal);
+    trackIndex("pay", 1, kEventPriorityCritical);
+    trackIndex("bulk", 2, kEventPriorityBulk);
+    CHECK(platform_stub::callCount() == 0);
+
+    EventLanes::drainAll();
+    std::vector<std::string> calls = platform_stub::takeCalls();
+    CHECK(calls.size() == 5);
+    CHECK(calls.size() == 5 && calls[0] == "track pay {\"index\":1}");
+    CHECK(calls.size() == 5 && calls[1] == "flush");
+    CHECK(calls.size() == 5 && calls[2] == "track normal {\"index\":1}");
+    CHECK(calls.size() == 5 && calls[3] == "track bulk {\"index\":1}");
+    CHECK(calls.size() == 5 && calls[4] == "track bulk {\"index\":2}");
+}
+
+static void testClearDropsQueued() {
+    reset();
+    EventLanes::setLaneConfig(kEventPriorityBulk, LaneConfig(0, 10, kLaneDropOldest, false));
+    trackIndex("bulk", 1, kEventPriorityBulk);
+    trackIndex("bulk", 2, kEventPriorityBulk);
+    EventLanes::clear();
+    CHECK(EventLanes::pendingCount(kEventPriorityBulk) == 0);
+    EventLanes::drainAll();
+    CHECK(platform_stub::callCount() == 0);
+}
+
+static void testEventTimeCapturedAtTrack() {
+    reset();
+    EventLanes::setLaneConfig(kEventPriorityBulk, LaneConfig(0, 10, kLaneDropOldest, false));
+    int64_t before = nowMillis();
+    trackIndex("bulk", 1, kEventPriorityBulk);
+    int64_t after = nowMillis();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EventLanes::drainAll();
+    std::vector<int64_t> eventTimes = platform_stub::takeEventTimes();
+    CHECK(eventTimes.size() == 1);
+    CHECK(eventTimes.size() == 1 && eventTimes[0] >= before && eventTimes[0] <= after);
+
+    // 直接发送的事件由原生 SDK 使用当前时间
+    trackIndex("normal", 1, kEventPriorityNormal);
+    eventTimes = platform_stub::takeEventTimes();
+    CHECK(eventTimes.size() == 1 && eventTimes[0] == 0);
+}
+
+int main() {
+    for (int priority = 0; priority < kEventPriorityCount; ++priority) {
+        sDefaultConfigs[priority] = EventLanes::getLaneConfig(static_cast<EventPriority>(priority));
+    }
+    testNormalSendsDirectly();
+    testCriticalFlushesAfterDeliver();
+    testBulkThreshold();
+    testDropOldest();
+    testDropNewest();
+    testDrainAllByPriority();
+    testClearDropsQueued();
+    testEventTimeCapturedAtTrack();
+    reset();
+    if (platform_stub::failures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", platform_stub::failures);
+        return 1;
+    }
+    printf("event_lanes_test passed\n");
+    return 0;
+}
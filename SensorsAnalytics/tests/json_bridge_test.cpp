@@ -0,0 +1,284 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../android/JSONBridge.h"
+#include <stdio.h>
+#include <string.h>
+#include <map>
+#include <set>
+#include <string>
+
+using namespace sensorsdata;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++sFailures; \
+        } \
+    } while (0)
+
+static int sFailures = 0;
+
+/**
+ * 伪造的 JNIEnv，记录引用与 direct ByteBuffer 的分配情况
+ */
+struct FakeJni {
+    std::set<jobject> localRefs;
+    std::set<jobject> globalRefs;
+    // direct ByteBuffer 局部/全局引用对应的内存与容量
+    std::map<jobject, std::pair<void *, jlong> > directBuffers;
+    int directBufferAllocations;
+    int newStringUTFCalls;
+    int javaCalls;
+    bool pendingException;
+    bool throwOnNextCall;
+    // 模拟 SAJSONBridge 不能解析的 JSON，返回 null
+    bool rejectOnNextCall;
+    // Java 层收到的 JSON
+    std::string lastPayload;
+    const void *lastPayloadAddress;
+    // 在 Java 方法中再次调用 toJSONObject，用于验证调用 Java 方法期间不持有锁
+    bool reenterOnNextCall;
+    JNIEnv *env;
+
+    FakeJni() : directBufferAllocations(0), newStringUTFCalls(0), javaCalls(0), pendingException(false),
+                throwOnNextCall(false), rejectOnNextCall(false), lastPayloadAddress(NULL), reenterOnNextCall(false), env(NULL) {}
+
+    jobject newLocal() {
+        jobject ref = new _jobject();
+        localRefs.insert(ref);
+        return ref;
+    }
+};
+
+static FakeJni *sFake = NULL;
+static _jmethodID *const kAdapterMethod = reinterpret_cast<_jmethodID *>(0x1);
+static _jmethodID *const kConstructor = reinterpret_cast<_jmethodID *>(0x2);
+
+static jclass fakeFindClass(JNIEnv *, const char *) {
+    return sFake->newLocal();
+}
+
+static jmethodID fakeGetMethodID(JNIEnv *, jclass, const char *, const char *) {
+    return kConstructor;
+}
+
+static jstring fakeNewStringUTF(JNIEnv *, const char *bytes) {
+    ++sFake->newStringUTFCalls;
+    sFake->lastPayload = bytes;
+    return sFake->newLocal();
+}
+
+static jobject fakeNewObjectV(JNIEnv *, jclass, jmethodID, va_list) {
+    return sFake->newLocal();
+}
+
+static jobject fakeCallStaticObjectMethodV(JNIEnv *env, jclass, jmethodID methodID, va_list args) {
+    ++sFake->javaCalls;
+    CHECK(methodID == kAdapterMethod);
+    jobject byteBuffer = va_arg(args, jobject);
+    jint length = va_arg(args, jint);
+    std::map<jobject, std::pair<void *, jlong> >::const_iterator buffer = sFake->directBuffers.find(byteBuffer);
+    CHECK(buffer != sFake->directBuffers.end());
+    if (buffer == sFake->directBuffers.end()) return NULL;
+    CHECK(length <= buffer->second.second);
+    if (sFake->reenterOnNextCall) {
+        sFake->reenterOnNextCall = false;
+        jobject nested = JSONBridge::toJSONObject(env, "{\"nested\":true}");
+        CHECK(nested != NULL);
+        env->DeleteLocalRef(nested);
+    }
+    sFake->lastPayload.assign(static_cast<const char *>(buffer->second.first), static_cast<size_t>(length));
+    sFake->lastPayloadAddress = buffer->second.first;
+    if (sFake->throwOnNextCall) {
+        sFake->throwOnNextCall = false;
+        sFake->pendingException = true;
+        return NULL;
+    }
+    if (sFake->rejectOnNextCall) {
+        sFake->rejectOnNextCall = false;
+        return NULL;
+    }
+    return sFake->newLocal();
+}
+
+static jobject fakeNewDirectByteBuffer(JNIEnv *, void *address, jlong capacity) {
+    ++sFake->directBufferAllocations;
+    jobject ref = sFake->newLocal();
+    sFake->directBuffers[ref] = std::make_pair(address, capacity);
+    return ref;
+}
+
+static jobject fakeNewGlobalRef(JNIEnv *, jobject obj) {
+    CHECK(sFake->localRefs.count(obj) == 1 || sFake->globalRefs.count(obj) == 1);
+    jobject ref = new _jobject();
+    sFake->globalRefs.insert(ref);
+    std::map<jobject, std::pair<void *, jlong> >::const_iterator buffer = sFake->directBuffers.find(obj);
+    if (buffer != sFake->directBuffers.end()) {
+        sFake->directBuffers[ref] = buffer->second;
+    }
+    return ref;
+}
+
+static void fakeDeleteGlobalRef(JNIEnv *, jobject obj) {
+    CHECK(sFake->globalRefs.erase(obj) == 1);
+    sFake->directBuffers.erase(obj);
+    delete obj;
+}
+
+static void fakeDeleteLocalRef(JNIEnv *, jobject obj) {
+    if (obj == NULL) return;
+    CHECK(sFake->localRefs.erase(obj) == 1);
+    sFake->directBuffers.erase(obj);
+    delete obj;
+}
+
+static jboolean fakeExceptionCheck(JNIEnv *) {
+    return sFake->pendingException ? 1 : 0;
+}
+
+static void fakeExceptionClear(JNIEnv *) {
+    sFake->pendingException = false;
+}
+
+static const JNINativeInterface kFakeFunctions = {
+        fakeFindClass,
+        fakeGetMethodID,
+        fakeNewStringUTF,
+        fakeNewObjectV,
+        fakeCallStaticObjectMethodV,
+        fakeNewDirectByteBuffer,
+        fakeNewGlobalRef,
+        fakeDeleteGlobalRef,
+        fakeDeleteLocalRef,
+        fakeExceptionCheck,
+        fakeExceptionClear,
+};
+
+/**
+ * 模拟调用方：创建 JSONObject 后释放
+ */
+static bool bridge(JNIEnv *env, const std::string &json) {
+    jobject object = JSONBridge::toJSONObject(env, json);
+    if (object == NULL) return false;
+    env->DeleteLocalRef(object);
+    return true;
+}
+
+static void testFallbackWithoutAdapter(JNIEnv *env) {
+    CHECK(!JSONBridge::hasAdapter());
+    CHECK(bridge(env, "{\"a\":1}"));
+    CHECK(sFake->newStringUTFCalls == 1);
+    CHECK(sFake->lastPayload == "{\"a\":1}");
+    CHECK(sFake->directBufferAllocations == 0);
+    CHECK(sFake->localRefs.empty());
+}
+
+static void testPooledBufferIsReused(JNIEnv *env) {
+    jobject adapterClass = sFake->newLocal();
+    JSONBridge::setAdapter(env, adapterClass, kAdapterMethod);
+    env->DeleteLocalRef(adapterClass);
+    CHECK(JSONBridge::hasAdapter());
+    size_t adapterGlobalRefs = sFake->globalRefs.size();
+
+    for (int i = 0; i < 100; ++i) {
+        std::string json = "{\"index\":" + std::to_string(i) + "}";
+        CHECK(bridge(env, json));
+        CHECK(sFake->lastPayload == json);
+    }
+    CHECK(sFake->newStringUTFCalls == 1);
+    CHECK(sFake->javaCalls == 100);
+    // 只分配一次 direct ByteBuffer，并以全局引用复用
+    CHECK(sFake->directBufferAllocations == 1);
+    CHECK(sFake->globalRefs.size() == adapterGlobalRefs + 1);
+    CHECK(sFake->localRefs.empty());
+
+    // 超过初始容量时重新分配，旧的全局引用被释放
+    std::string large = "{\"s\":\"" + std::string(10 * 1024, 'x') + "\"}";
+    CHECK(bridge(env, large));
+    CHECK(sFake->lastPayload == large);
+    CHECK(sFake->directBufferAllocations == 2);
+    CHECK(sFake->globalRefs.size() == adapterGlobalRefs + 1);
+    CHECK(sFake->localRefs.empty());
+}
+
+static void testOversizedPayloadUsesTemporaryBuffer(JNIEnv *env) {
+    size_t globalRefs = sFake->globalRefs.size();
+    int allocations = sFake->directBufferAllocations;
+    std::string huge = "{\"s\":\"" + std::string(300 * 1024, 'y') + "\"}";
+    CHECK(bridge(env, huge));
+    // 直接包装 json 的内存，不复制，也不放入复用的 ByteBuffer
+    CHECK(sFake->lastPayloadAddress == huge.data());
+    CHECK(sFake->directBufferAllocations == allocations + 1);
+    CHECK(sFake->globalRefs.size() == globalRefs);
+    CHECK(sFake->localRefs.empty());
+}
+
+static void testJavaExceptionFallsBackToString(JNIEnv *env) {
+    int stringCalls = sFake->newStringUTFCalls;
+    sFake->throwOnNextCall = true;
+    CHECK(bridge(env, "{\"bad\":1}"));
+    CHECK(!sFake->pendingException);
+    CHECK(sFake->newStringUTFCalls == stringCalls + 1);
+    CHECK(sFake->lastPayload == "{\"bad\":1}");
+    CHECK(sFake->localRefs.empty());
+    CHECK(bridge(env, "{\"ok\":true}"));
+}
+
+static void testRejectedPayloadFallsBackToString(JNIEnv *env) {
+    // setNumber("x", NAN) 序列化为 nan，SAJSONBridge 不接受，JSONObject(String) 按字符串解析
+    int stringCalls = sFake->newStringUTFCalls;
+    sFake->rejectOnNextCall = true;
+    CHECK(bridge(env, "{\"x\":nan,\"y\":1}"));
+    CHECK(sFake->newStringUTFCalls == stringCalls + 1);
+    CHECK(sFake->lastPayload == "{\"x\":nan,\"y\":1}");
+    CHECK(sFake->localRefs.empty());
+}
+
+static void testNoLockHeldDuringJavaCall(JNIEnv *env) {
+    size_t globalRefs = sFake->globalRefs.size();
+    sFake->reenterOnNextCall = true;
+    // 调用 Java 方法期间持有全局锁时，嵌套调用会死锁
+    CHECK(bridge(env, "{\"outer\":true}"));
+    CHECK(sFake->lastPayload == "{\"outer\":true}");
+    // 嵌套调用使用第二个复用的 ByteBuffer
+    CHECK(sFake->globalRefs.size() == globalRefs + 1);
+    CHECK(sFake->localRefs.empty());
+}
+
+int main() {
+    FakeJni fake;
+    sFake = &fake;
+    JNIEnv env;
+    env.functions = &kFakeFunctions;
+    fake.env = &env;
+
+    testFallbackWithoutAdapter(&env);
+    testPooledBufferIsReused(&env);
+    testOversizedPayloadUsesTemporaryBuffer(&env);
+    testJavaExceptionFallsBackToString(&env);
+    testRejectedPayloadFallsBackToString(&env);
+    testNoLockHeldDuringJavaCall(&env);
+
+    if (sFailures != 0) {
+        fprintf(stderr, "%d check(s) failed\n", sFailures);
+        return 1;
+    }
+    printf("json_bridge_test passed\n");
+    return 0;
+}
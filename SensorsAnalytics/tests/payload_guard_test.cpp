@@ -0,0 +1,178 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "platform_stub.h"
+#include "../include/SensorsAnalytics.h"
+
+using namespace sensorsdata;
+
+static void reset(const PayloadBudget &budget) {
+    PayloadGuard::setBudget(budget);
+    PayloadGuard::resetStats();
+    StatsRecorder::reset();
+    platform_stub::takeCalls();
+}
+
+static void testStringTruncatedOnUtf8Boundary() {
+    PayloadBudget budget;
+    budget.maxStringBytes = 5;
+    reset(budget);
+    // "a中文"：'a' 1 个字节，'中'、'文' 各 3 个字节，第 5 个字节位于 '文' 的中间
+    string value("a\xE4\xB8\xAD\xE6\x96\x87");
+    CHECK(PayloadGuard::truncateString(&value));
+    CHECK(value == "a\xE4\xB8\xAD");
+
+    string shortValue("a\xE4\xB8\xAD");
+    CHECK(!PayloadGuard::truncateString(&shortValue));
+    CHECK(shortValue == "a\xE4\xB8\xAD");
+
+    ObjectNode properties;
+    properties.setString("name", "a\xE4\xB8\xAD\xE6\x96\x87");
+    CHECK(ObjectNode::toJson(properties) == "{\"name\":\"a\xE4\xB8\xAD\"}");
+    CHECK(PayloadGuard::getStats().truncatedStrings == 2);
+}
+
+static void testListItemBudget() {
+    PayloadBudget budget;
+    budget.maxListItems = 2;
+    reset(budget);
+    std::vector<string> items;
+    items.push_back("a");
+    items.push_back("b");
+    items.push_back("c");
+    ObjectNode properties;
+    properties.setList("tags", items);
+    CHECK(ObjectNode::toJson(properties) == "{\"tags\":[\"a\",\"b\"]}");
+    CHECK(PayloadGuard::getStats().truncatedLists == 1);
+}
+
+static void testListByteBudget() {
+    PayloadBudget budget;
+    // ["aaa","bbb"] 为 13 个字节，只能放下第一个元素
+    budget.maxListBytes = 12;
+    reset(budget);
+    std::vector<string> items;
+    items.push_back("aaa");
+    items.push_back("bbb");
+    items.push_back("ccc");
+    CHECK(PayloadGuard::truncateList(&items));
+    CHECK(items.size() == 1 && items[0] == "aaa");
+
+    // 按转义后的长度计算，"a\"" 转义后为 5 个字节
+    std::vector<string> escaped;
+    escaped.push_back("a\"");
+    escaped.push_back("b\"");
+    CHECK(PayloadGuard::truncateList(&escaped));
+    CHECK(escaped.size() == 1);
+
+    std::vector<string> fits;
+    fits.push_back("aaa");
+    fits.push_back("bb");
+    CHECK(!PayloadGuard::truncateList(&fits));
+    CHECK(fits.size() == 2);
+    CHECK(PayloadGuard::getStats().truncatedLists == 2);
+}
+
+static void checkPayloadSize(const ObjectNode &properties) {
+    string json = ObjectNode::toJson(properties);
+    CHECK(properties.payloadSize() == json.length());
+    if (properties.payloadSize() != json.length()) {
+        fprintf(stderr, "payloadSize %zu != %zu for %s\n", properties.payloadSize(), json.length(), json.c_str());
+    }
+}
+
+static void testPayloadSizeMatchesJson() {
+    reset(PayloadBudget());
+    ObjectNode properties;
+    checkPayloadSize(properties);
+
+    properties.setString("quote", "a\"b\\c\n\t");
+    properties.setNumber("int", 42);
+    properties.setNumber("double", 1.5);
+    properties.setBool("flag", true);
+    properties.setDateTime("time", 1700000000, 123);
+    properties.setDateTime("timeString", "2026-10-19 10:00:00.000");
+    std::vector<string> items;
+    items.push_back("x\"");
+    items.push_back("");
+    properties.setList("list", items);
+    properties.setString("key\"with\\escapes", "v");
+    checkPayloadSize(properties);
+
+    // 覆盖为长度不同的值
+    properties.setString("quote", "");
+    properties.setNumber("int", static_cast<int64_t>(-1234567890123LL));
+    properties.setBool("flag", false);
+    checkPayloadSize(properties);
+
+    static PropertyKey levelKey("level");
+    properties.setNumber(levelKey, 1);
+    properties.setNumber("level", 2);
+    checkPayloadSize(properties);
+
+    ObjectNode merged;
+    merged.setString("int", "replaced");
+    merged.setNumber("extra", 7);
+    merged.mergeFrom(properties);
+    checkPayloadSize(merged);
+
+    merged.clear();
+    checkPayloadSize(merged);
+}
+
+static void testAcceptEventRejectsOversized() {
+    PayloadBudget budget;
+    // {"name":"0123456789"} 为 21 个字节
+    budget.maxEventBytes = 21;
+    reset(budget);
+    StatsRecorder::setEnabled(true);
+
+    ObjectNode fits;
+    fits.setString("name", "0123456789");
+    CHECK(fits.payloadSize() == 21);
+    CHECK(PayloadGuard::acceptEvent(fits));
+
+    ObjectNode oversized;
+    oversized.setString("name", "0123456789a");
+    CHECK(!PayloadGuard::acceptEvent(oversized));
+    SensorsAnalytics::track("oversized", oversized);
+    CHECK(platform_stub::callCount() == 0);
+    CHECK(PayloadGuard::getStats().rejectedEvents == 2);
+    CHECK(StatsRecorder::snapshot().droppedEvents == 2);
+
+    // maxEventBytes 为 0 时不限制
+    budget.maxEventBytes = 0;
+    PayloadGuard::setBudget(budget);
+    CHECK(PayloadGuard::acceptEvent(oversized));
+    CHECK(PayloadGuard::getStats().rejectedEvents == 2);
+    StatsRecorder::setEnabled(false);
+}
+
+int main() {
+    testStringTruncatedOnUtf8Boundary();
+    testListItemBudget();
+    testListByteBudget();
+    testPayloadSizeMatchesJson();
+    testAcceptEventRejectsOversized();
+    PayloadGuard::setBudget(PayloadBudget());
+    if (platform_stub::failures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", platform_stub::failures);
+        return 1;
+    }
+    printf("payload_guard_test passed\n");
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "platform_stub.h"
+#include "../common/PlatformBridge.h"
+#include "../include/SensorsAnalytics.h"
+#include <mutex>
+
+using namespace sensorsdata;
+
+namespace {
+    std::mutex sMutex;
+    std::vector<std::string> sCalls;
+    std::vector<int64_t> sEventTimes;
+
+    void record(const std::string &call) {
+        std::lock_guard<std::mutex> lock(sMutex);
+        sCalls.push_back(call);
+    }
+
+    void recordTrack(const std::string &call, int64_t eventTimeMillis) {
+        std::lock_guard<std::mutex> lock(sMutex);
+        sCalls.push_back(call);
+        sEventTimes.push_back(eventTimeMillis);
+    }
+}
+
+int platform_stub::failures = 0;
+
+std::vector<std::string> platform_stub::takeCalls() {
+    std::lock_guard<std::mutex> lock(sMutex);
+    std::vector<std::string> calls;
+    calls.swap(sCalls);
+    return calls;
+}
+
+std::vector<int64_t> platform_stub::takeEventTimes() {
+    std::lock_guard<std::mutex> lock(sMutex);
+    std::vector<int64_t> eventTimes;
+    eventTimes.swap(sEventTimes);
+    return eventTimes;
+}
+
+size_t platform_stub::callCount() {
+    std::lock_guard<std::mutex> lock(sMutex);
+    return sCalls.size();
+}
+
+void platform::track(const char *eventName, const ObjectNode &properties, const EventKey &eventKey,
+                     int64_t eventTimeMillis) {
+    recordTrack(std::string("track ") + (eventKey.isValid() ? eventKey.name() : string(eventName)) + " " +
+                ObjectNode::toJson(properties), eventTimeMillis);
+}
+
+void platform::track(const SerializedEvent &event, int64_t eventTimeMillis) {
+    recordTrack("track " + event.eventName() + " " + event.json(), eventTimeMillis);
+}
+
+void platform::flush() {
+    record("flush");
+}
+
+void platform::profileSet(const ObjectNode &properties) {
+    record("profileSet " + ObjectNode::toJson(properties));
+}
+
+void platform::profileSetOnce(const ObjectNode &properties) {
+    record("profileSetOnce " + ObjectNode::toJson(properties));
+}
+
+void platform::itemSet(const char *itemType, const char *itemId, const ObjectNode &properties) {
+    record(std::string("itemSet ") + itemType + "/" + itemId + " " + ObjectNode::toJson(properties));
+}
+
+void platform::attachFrameTick() {
+}
+
+void platform::detachFrameTick() {
+}
+
+// 主机上没有原生 SDK 实例与 JNI 方法查找，SensorsAnalytics::warmUp 只预热 common 中的部分
+bool platform::warmUp() {
+    return true;
+}
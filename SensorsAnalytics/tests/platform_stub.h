@@ -0,0 +1,58 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef COCOS2DX_SENSORS_TESTS_PLATFORM_STUB_H_
+#define COCOS2DX_SENSORS_TESTS_PLATFORM_STUB_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++platform_stub::failures; \
+        } \
+    } while (0)
+
+/**
+ * 在主机上代替 android/ios 的 platform 实现，按调用顺序记录发往原生 SDK 的数据，例如
+ * "profileSet {"a":1}"、"itemSet type/id {"a":1}"、"track name {...}"、"flush"
+ */
+namespace platform_stub {
+    extern int failures;
+
+    /**
+     * 取出已记录的调用
+     */
+    std::vector<std::string> takeCalls();
+
+    /**
+     * 取出 track 调用传入的事件时间，与 track 调用一一对应，0 表示未指定
+     */
+    std::vector<int64_t> takeEventTimes();
+
+    /**
+     * 已记录的调用个数
+     */
+    size_t callCount();
+}
+
+#endif // COCOS2DX_SENSORS_TESTS_PLATFORM_STUB_H_
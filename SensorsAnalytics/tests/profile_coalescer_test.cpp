@@ -0,0 +1,205 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "platform_stub.h"
+#include "../include/SensorsAnalytics.h"
+#include <chrono>
+#include <thread>
+
+using namespace sensorsdata;
+
+// 足够长的窗口，保证测试过程中窗口不会自然结束
+static const uint32_t kLongWindowMillis = 60 * 1000;
+
+static void reset(uint32_t windowMillis) {
+    ProfileCoalescer::setWindow(0);
+    ProfileCoalescer::clear();
+    PayloadGuard::setBudget(PayloadBudget());
+    platform_stub::takeCalls();
+    ProfileCoalescer::setWindow(windowMillis);
+}
+
+static void testDisabledSendsDirectly() {
+    reset(0);
+    ObjectNode properties;
+    properties.setNumber("level", 1);
+    SensorsAnalytics::profileSet(properties);
+    std::vector<std::string> calls = platform_stub::takeCalls();
+    CHECK(calls.size() == 1);
+    CHECK(calls.size() == 1 && calls[0] == "profileSet {\"level\":1}");
+}
+
+static void testProfileSetLastWriteWins() {
+    reset(kLongWindowMillis);
+    ObjectNode first;
+    first.setNumber("level", 1);
+    first.setString("name", "a");
+    ObjectNode second;
+    second.setNumber("level", 2);
+    SensorsAnalytics::profileSet(first);
+    SensorsAnalytics::profileSet(second);
+    CHECK(platform_stub::callCount() == 0);
+
+    ProfileCoalescer::flush();
+    std::vector<std::string> calls = platform_stub::takeCalls();
+    CHECK(calls.size() == 1);
+    CHECK(calls.size() == 1 && calls[0] == "profileSet {\"level\":2,\"name\":\"a\"}");
+}
+
+static void testProfileSetOnceFirstWriteWins() {
+    reset(kLongWindowMillis);
+    ObjectNode first;
+    first.setString("channel", "store");
+    ObjectNode second;
+    second.setString("channel", "ad");
+    second.setNumber("firstLevel", 3);
+    SensorsAnalytics::profileSetOnce(first);
+    SensorsAnalytics::profileSetOnce(second);
+
+    ProfileCoalescer::flush();
+    std::vector<std::string> calls = platform_stub::takeCalls();
+    CHECK(calls.size() == 1);
+    CHECK(calls.size() == 1 && calls[0] == "profileSetOnce {\"channel\":\"store\",\"firstLevel\":3}");
+}
+
+static void testItemSetMergesPerItem() {
+    reset(kLongWindowMillis);
+    ObjectNode price;
+    price.setNumber("price", 10);
+    ObjectNode discount;
+    discount.setNumber("price", 8);
+    ObjectNode other;
+    other.setNumber("price", 1);
+    SensorsAnalytics::itemSet("sword", "1", price);
+    SensorsAnalytics::itemSet("shield", "1", other);
+    SensorsAnalytics::itemSet("sword", "1", discount);
+
+    ProfileCoalescer::flush();
+    std::vector<std::string> calls = platform_stub::takeCalls();
+    CHECK(calls.size() == 2);
+    CHECK(calls.size() == 2 && calls[0] == "itemSet shield/1 {\"price\":1}");
+    CHECK(calls.size() == 2 && calls[1] == "itemSet sword/1 {\"price\":8}");
+}
+
+static void testItemDeleteDiscardsPendingItem() {
+    reset(kLongWindowMillis);
+    ObjectNode properties;
+    properties.setNumber("price", 10);
+    SensorsAnalytics::itemSet("sword", "1", properties);
+    SensorsAnalytics::itemSet("sword", "2", properties);
+    // itemDelete 在调用原生 SDK 之前丢弃未发送的 itemSet
+    ProfileCoalescer::discardItem("sword", "1");
+
+    ProfileCoalescer::flush();
+    std::vector<std::string> calls = platform_stub::takeCalls();
+    CHECK(calls.size() == 1);
+    CHECK(calls.size() == 1 && calls[0] == "itemSet sword/2 {\"price\":10}");
+}
+
+static void testIdentityFlushSendsInOrder() {
+    reset(kLongWindowMillis);
+    ObjectNode set;
+    set.setNumber("level", 1);
+    ObjectNode setOnce;
+    setOnce.setString("channel", "store");
+    ObjectNode item;
+    item.setNumber("price", 10);
+    SensorsAnalytics::itemSet("sword", "1", item);
+    SensorsAnalytics::profileSetOnce(setOnce);
+    SensorsAnalytics::profileSet(set);
+
+    // identify/login/logout 在调用原生 SDK 之前发送已合并的数据，之后的数据属于新用户
+    ProfileCoalescer::flush();
+    ObjectNode next;
+    next.setNumber("level", 9);
+    SensorsAnalytics::profileSet(next);
+    std::vector<std::string> calls = platform_stub::takeCalls();
+    CHECK(calls.size() == 3);
+    CHECK(calls.size() == 3 && calls[0] == "profileSet {\"level\":1}");
+    CHECK(calls.size() == 3 && calls[1] == "profileSetOnce {\"channel\":\"store\"}");
+    CHECK(calls.size() == 3 && calls[2] == "itemSet sword/1 {\"price\":10}");
+
+    ProfileCoalescer::flush();
+    calls = platform_stub::takeCalls();
+    CHECK(calls.size() == 1 && calls[0] == "profileSet {\"level\":9}");
+}
+
+static void testLoneUpdateSentByTimer() {
+    reset(20);
+    ObjectNode properties;
+    properties.setNumber("level", 1);
+    SensorsAnalytics::profileSet(properties);
+    // 未启动 WorkScheduler，也没有后续调用，由定时线程在窗口结束时发送
+    for (int i = 0; i < 200 && platform_stub::callCount() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::vector<std::string> calls = platform_stub::takeCalls();
+    CHECK(calls.size() == 1);
+    CHECK(calls.size() == 1 && calls[0] == "profileSet {\"level\":1}");
+}
+
+static void testOversizedMergeFlushesEarly() {
+    reset(kLongWindowMillis);
+    ObjectNode first;
+    first.setString("a", "0123456789");
+    ObjectNode second;
+    second.setString("b", "0123456789");
+    PayloadBudget budget;
+    budget.maxEventBytes = first.payloadSize() + second.payloadSize() - 1;
+    PayloadGuard::setBudget(budget);
+
+    SensorsAnalytics::profileSet(first);
+    CHECK(platform_stub::callCount() == 0);
+    // 合并后会超过上限，先单独发送已合并的记录
+    SensorsAnalytics::profileSet(second);
+    std::vector<std::string> calls = platform_stub::takeCalls();
+    CHECK(calls.size() == 1);
+    CHECK(calls.size() == 1 && calls[0] == "profileSet {\"a\":\"0123456789\"}");
+
+    ProfileCoalescer::flush();
+    calls = platform_stub::takeCalls();
+    CHECK(calls.size() == 1 && calls[0] == "profileSet {\"b\":\"0123456789\"}");
+}
+
+static void testClearDropsPending() {
+    reset(kLongWindowMillis);
+    ObjectNode properties;
+    properties.setNumber("level", 1);
+    SensorsAnalytics::profileSet(properties);
+    ProfileCoalescer::clear();
+    ProfileCoalescer::flush();
+    CHECK(platform_stub::callCount() == 0);
+}
+
+int main() {
+    testDisabledSendsDirectly();
+    testProfileSetLastWriteWins();
+    testProfileSetOnceFirstWriteWins();
+    testItemSetMergesPerItem();
+    testItemDeleteDiscardsPendingItem();
+    testIdentityFlushSendsInOrder();
+    testLoneUpdateSentByTimer();
+    testOversizedMergeFlushesEarly();
+    testClearDropsPending();
+    ProfileCoalescer::setWindow(0);
+    if (platform_stub::failures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", platform_stub::failures);
+        return 1;
+    }
+    printf("profile_coalescer_test passed\n");
+    return 0;
+}
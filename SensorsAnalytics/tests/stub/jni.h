@@ -0,0 +1,100 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * 仅用于在主机上编译测试的精简 jni.h，只声明 JSONBridge 用到的函数。
+ * 与真实的 jni.h 一样，JNIEnv 的方法通过 functions 函数表调用，测试通过替换函数表伪造 JNIEnv。
+ */
+
+#ifndef COCOS2DX_SENSORS_TESTS_STUB_JNI_H_
+#define COCOS2DX_SENSORS_TESTS_STUB_JNI_H_
+
+#include <stdarg.h>
+#include <stdint.h>
+
+typedef int32_t jint;
+typedef int64_t jlong;
+typedef uint8_t jboolean;
+
+class _jobject {};
+typedef _jobject *jobject;
+typedef jobject jclass;
+typedef jobject jstring;
+
+struct _jmethodID;
+typedef struct _jmethodID *jmethodID;
+
+struct _JNIEnv;
+typedef _JNIEnv JNIEnv;
+
+struct JNINativeInterface {
+    jclass (*FindClass)(JNIEnv *, const char *);
+    jmethodID (*GetMethodID)(JNIEnv *, jclass, const char *, const char *);
+    jstring (*NewStringUTF)(JNIEnv *, const char *);
+    jobject (*NewObjectV)(JNIEnv *, jclass, jmethodID, va_list);
+    jobject (*CallStaticObjectMethodV)(JNIEnv *, jclass, jmethodID, va_list);
+    jobject (*NewDirectByteBuffer)(JNIEnv *, void *, jlong);
+    jobject (*NewGlobalRef)(JNIEnv *, jobject);
+    void (*DeleteGlobalRef)(JNIEnv *, jobject);
+    void (*DeleteLocalRef)(JNIEnv *, jobject);
+    jboolean (*ExceptionCheck)(JNIEnv *);
+    void (*ExceptionClear)(JNIEnv *);
+};
+
+struct _JNIEnv {
+    const JNINativeInterface *functions;
+
+    jclass FindClass(const char *name) { return functions->FindClass(this, name); }
+
+    jmethodID GetMethodID(jclass clazz, const char *name, const char *sig) {
+        return functions->GetMethodID(this, clazz, name, sig);
+    }
+
+    jstring NewStringUTF(const char *bytes) { return functions->NewStringUTF(this, bytes); }
+
+    jobject NewObject(jclass clazz, jmethodID methodID, ...) {
+        va_list args;
+        va_start(args, methodID);
+        jobject result = functions->NewObjectV(this, clazz, methodID, args);
+        va_end(args);
+        return result;
+    }
+
+    jobject CallStaticObjectMethod(jclass clazz, jmethodID methodID, ...) {
+        va_list args;
+        va_start(args, methodID);
+        jobject result = functions->CallStaticObjectMethodV(this, clazz, methodID, args);
+        va_end(args);
+        return result;
+    }
+
+    jobject NewDirectByteBuffer(void *address, jlong capacity) {
+        return functions->NewDirectByteBuffer(this, address, capacity);
+    }
+
+    jobject NewGlobalRef(jobject obj) { return functions->NewGlobalRef(this, obj); }
+
+    void DeleteGlobalRef(jobject obj) { functions->DeleteGlobalRef(this, obj); }
+
+    void DeleteLocalRef(jobject obj) { functions->DeleteLocalRef(this, obj); }
+
+    jboolean ExceptionCheck() { return functions->ExceptionCheck(this); }
+
+    void ExceptionClear() { functions->ExceptionClear(this); }
+};
+
+#endif // COCOS2DX_SENSORS_TESTS_STUB_JNI_H_
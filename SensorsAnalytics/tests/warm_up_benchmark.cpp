@@ -0,0 +1,115 @@
+/*
+ * Created on 2026/10/19.
+ * Copyright 2015－2026 Sensors Data Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * 对比调用与不调用 warmUp 时首次 track 的耗时。
+ * 首次调用的开销只出现一次，因此每个样本在新的子进程中测量，父进程汇总中位数与 P90。
+ * 调用的是 common 中真实的 SensorsAnalytics::warmUp，platform_stub.cpp 只代替 platform::warmUp 的
+ * 平台部分，因此主机上测得的只是 common 部分（ObjectNode 的序列化、时间格式化、队列的创建等）的收益；
+ * JNI 方法查找、JSONBridge 缓冲区与用户标识加载需在设备上测量：在 App 启动后的同一位置分别以
+ * 冷启动与调用 warmUp 后的方式记录首次 track 的耗时。
+ *
+ * 用法：warm_up_benchmark [样本数]
+ */
+
+#include "platform_stub.h"
+#include "../include/SensorsAnalytics.h"
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace sensorsdata;
+
+static const int kDefaultSamples = 50;
+
+/**
+ * 在当前进程中测量首次 track 的耗时，单位为纳秒
+ */
+static int64_t measureFirstTrack(bool warmUp) {
+    if (warmUp) {
+        SensorsAnalytics::warmUp();
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    ObjectNode properties;
+    properties.setString("level_name", "forest");
+    properties.setNumber("level", static_cast<int64_t>(3));
+    properties.setNumber("score", 1024.5);
+    properties.setDateTime("start_time", time(NULL), 250);
+    SensorsAnalytics::track("LevelStart", properties);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * 在新的子进程中测量，返回耗时，失败时返回 -1
+ */
+static int64_t sampleInChild(bool warmUp) {
+    int fds[2];
+    if (pipe(fds) != 0) return -1;
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        int64_t nanos = measureFirstTrack(warmUp);
+        ssize_t written = write(fds[1], &nanos, sizeof(nanos));
+        close(fds[1]);
+        _exit(written == sizeof(nanos) ? 0 : 1);
+    }
+    close(fds[1]);
+    int64_t nanos = -1;
+    if (read(fds[0], &nanos, sizeof(nanos)) != sizeof(nanos)) {
+        nanos = -1;
+    }
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return nanos;
+}
+
+static void report(const char *name, std::vector<int64_t> samples) {
+    if (samples.empty()) {
+        printf("%-8s no samples\n", name);
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    printf("%-8s samples=%zu median=%.1fus p90=%.1fus min=%.1fus\n", name, samples.size(),
+           samples[samples.size() / 2] / 1000.0, samples[samples.size() * 9 / 10] / 1000.0,
+           samples[0] / 1000.0);
+}
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : kDefaultSamples;
+    if (count <= 0) count = kDefaultSamples;
+    std::vector<int64_t> cold;
+    std::vector<int64_t> warm;
+    // 交替采样，避免系统状态的变化只影响其中一组
+    for (int i = 0; i < count; ++i) {
+        int64_t nanos = sampleInChild(false);
+        if (nanos >= 0) cold.push_back(nanos);
+        nanos = sampleInChild(true);
+        if (nanos >= 0) warm.push_back(nanos);
+    }
+    report("cold", cold);
+    report("warmUp", warm);
+    return cold.empty() || warm.empty() ? 1 : 0;
+}